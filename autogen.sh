@@ -195,6 +195,7 @@ if ! $skip_gnulib; then
       fnmatch
       fopen
       fstrcmp
+      fsync
       full-write
       fwriteerror
       gcd
@@ -211,7 +212,9 @@ if ! $skip_gnulib; then
       locale
       localename
       lock
+      lstat
       memmove
+      memory-ostream
       memset
       minmax
       obstack
@@ -225,11 +228,13 @@ if ! $skip_gnulib; then
       readdir
       relocatable-prog
       relocatable-script
+      rename
       setlocale
       sh-quote
       sigpipe
       sigprocmask
       spawn-pipe
+      stat-time
       stdbool
       stdio
       stdlib
@@ -342,13 +347,16 @@ if ! $skip_gnulib; then
       hash
       iconv
       libunistring-optional
+      lstat
       markup
+      memory-ostream
       minmax
       open
       ostream
       progname
       relocatable-lib
       sigpipe
+      stat-time
       stdbool
       stdio
       stdlib
@@ -307,7 +307,10 @@ set_binding_values (const char *domainname,
 
   /* If we modified any binding, we flush the caches.  */
   if (modified)
-    ++_nl_msg_cat_cntr;
+    {
+      ++_nl_msg_cat_cntr;
+      _nl_forget_catalog_lists ();
+    }
 
   gl_rwlock_unlock (_nl_state_lock);
 }
@@ -100,9 +100,11 @@ extern int errno;
 # include "libgnuintl.h"
 #endif
 #include "hash-string.h"
+#include "lz-block.h"
 
 /* Handle multi-threaded applications.  */
 #ifdef _LIBC
+# include <atomic.h>
 # include <bits/libc-lock.h>
 # define gl_rwlock_define_initialized __libc_rwlock_define_initialized
 # define gl_rwlock_rdlock __libc_rwlock_rdlock
@@ -230,6 +232,17 @@ static void *mempcpy (void *dest, const void *src, size_t n);
 # define HAVE_PER_THREAD_LOCALE
 #endif
 
+/* Version of the loaded catalogs of a text domain.  It is incremented
+   when textdomain_reload() replaces one of them, so that only the known
+   translations of this domain become invalid.  Records are never freed,
+   because the entries of the search tree point to them.  */
+struct domain_generation
+{
+  struct domain_generation *next;
+  int generation;
+  char domainname[ZERO];
+};
+
 /* This is the type used for the search tree where known translations
    are stored.  */
 struct known_translation_t
@@ -253,6 +266,16 @@ struct known_translation_t
   /* State of the catalog counter at the point the string was found.  */
   int counter;
 
+  /* Version of the domain's catalogs at the point the string was found.  */
+  const struct domain_generation *domaingen;
+  int generation;
+
+  /* Neighbours in the ring of entries that the eviction hand walks, and
+     whether the entry was used since the hand last passed it.  */
+  struct known_translation_t *clock_next;
+  struct known_translation_t *clock_prev;
+  int referenced;
+
   /* Catalog where the string was found.  */
   struct loaded_l10nfile *domain;
 
@@ -274,6 +297,76 @@ gl_rwlock_define_initialized (static, tree_lock)
 /* Root of the search tree with known translations.  */
 static void *root;
 
+/* List of the versions of the text domains that have known translations.
+   Protected by tree_lock.  */
+static struct domain_generation *domain_generations;
+
+/* Bookkeeping of the search tree, protected by tree_lock: the maximum
+   number of entries (0 for no limit), the current number of entries, and
+   the position of the eviction hand in the ring of all entries.  */
+static unsigned long int cache_limit;
+static unsigned long int cache_entries;
+static struct known_translation_t *clock_hand;
+
+/* Statistics about the search tree.  The hits and misses are counted
+   while tree_lock is only held for reading, therefore they are accessed
+   only through STATS_INCREMENT and STATS_READ.  The evictions are counted
+   while tree_lock is held for writing.  */
+static unsigned long int cache_hits;
+static unsigned long int cache_misses;
+static unsigned long int cache_evictions;
+
+#if defined _LIBC
+# define STATS_INCREMENT(var) atomic_increment (&(var))
+# define STATS_READ(var) atomic_exchange_and_add (&(var), 0)
+#elif __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)
+# define STATS_INCREMENT(var) ((void) __sync_fetch_and_add (&(var), 1))
+# define STATS_READ(var) __sync_fetch_and_add (&(var), 0)
+#else
+gl_lock_define_initialized (static, stats_lock)
+# define STATS_INCREMENT(var) \
+  do { gl_lock_lock (stats_lock); ++(var); gl_lock_unlock (stats_lock); } \
+  while (0)
+static unsigned long int
+stats_read (unsigned long int *varp)
+{
+  unsigned long int value;
+
+  gl_lock_lock (stats_lock);
+  value = *varp;
+  gl_lock_unlock (stats_lock);
+  return value;
+}
+# define STATS_READ(var) stats_read (&(var))
+#endif
+
+/* Return the version record of DOMAINNAME, creating it if it does not
+   exist yet.  Return NULL if out of memory.  The caller must hold
+   tree_lock for writing.  */
+static struct domain_generation *
+internal_function
+get_domain_generation (const char *domainname)
+{
+  struct domain_generation *runp;
+  size_t len;
+
+  for (runp = domain_generations; runp != NULL; runp = runp->next)
+    if (strcmp (runp->domainname, domainname) == 0)
+      return runp;
+
+  len = strlen (domainname) + 1;
+  runp = (struct domain_generation *)
+    malloc (offsetof (struct domain_generation, domainname) + len);
+  if (runp != NULL)
+    {
+      memcpy (runp->domainname, domainname, len);
+      runp->generation = 0;
+      runp->next = domain_generations;
+      domain_generations = runp;
+    }
+  return runp;
+}
+
 /* Function to compare two entries in the table of known translations.  */
 static int
 transcmp (const void *p1, const void *p2)
@@ -312,6 +405,64 @@ transcmp (const void *p1, const void *p2)
   return result;
 }
 
+/* Add the new entry NEWP of the search tree to the ring of entries.  The
+   caller must hold tree_lock for writing.  */
+static void
+internal_function
+clock_insert (struct known_translation_t *newp)
+{
+  newp->referenced = 0;
+  if (clock_hand == NULL)
+    {
+      newp->clock_next = newp;
+      newp->clock_prev = newp;
+      clock_hand = newp;
+    }
+  else
+    {
+      /* Insert it just behind the hand, so that it is visited last.  */
+      newp->clock_next = clock_hand;
+      newp->clock_prev = clock_hand->clock_prev;
+      clock_hand->clock_prev->clock_next = newp;
+      clock_hand->clock_prev = newp;
+    }
+  ++cache_entries;
+}
+
+/* Remove entries from the search tree until it holds at most LIMIT of
+   them.  An entry that was used since the hand last passed it gets a
+   second chance.  The caller must hold tree_lock for writing.  */
+static void
+internal_function
+clock_evict (unsigned long int limit)
+{
+  while (cache_entries > limit)
+    {
+      struct known_translation_t *victim = clock_hand;
+
+      if (victim->referenced)
+	{
+	  victim->referenced = 0;
+	  clock_hand = victim->clock_next;
+	  continue;
+	}
+
+      if (victim->clock_next == victim)
+	clock_hand = NULL;
+      else
+	{
+	  victim->clock_prev->clock_next = victim->clock_next;
+	  victim->clock_next->clock_prev = victim->clock_prev;
+	  clock_hand = victim->clock_next;
+	}
+
+      tdelete (victim, &root, transcmp);
+      free (victim);
+      --cache_entries;
+      ++cache_evictions;
+    }
+}
+
 /* Name of the default domain used for gettext(3) prior any call to
    textdomain(3).  The default value for this is "messages".  */
 const char _nl_default_default_domain[] attribute_hidden = "messages";
@@ -348,6 +499,10 @@ static char *plural_lookup (struct loaded_l10nfile *domain,
 			    const char *translation, size_t translation_len)
      internal_function;
 
+static char *find_compressed_string (struct loaded_domain *domain,
+				     nls_uint32 offset, size_t length)
+     internal_function;
+
 #ifdef IN_LIBGLOCALE
 static const char *guess_category_value (int category,
 					 const char *categoryname,
@@ -377,34 +532,7 @@ static const char *get_output_charset (struct binding *domainbinding)
 #ifdef HAVE_ALLOCA
 /* Nothing has to be done.  */
 # define freea(p) /* nothing */
-# define ADD_BLOCK(list, address) /* nothing */
-# define FREE_BLOCKS(list) /* nothing */
 #else
-struct block_list
-{
-  void *address;
-  struct block_list *next;
-};
-# define ADD_BLOCK(list, addr)						      \
-  do {									      \
-    struct block_list *newp = (struct block_list *) malloc (sizeof (*newp));  \
-    /* If we cannot get a free block we cannot add the new element to	      \
-       the list.  */							      \
-    if (newp != NULL) {							      \
-      newp->address = (addr);						      \
-      newp->next = (list);						      \
-      (list) = newp;							      \
-    }									      \
-  } while (0)
-# define FREE_BLOCKS(list)						      \
-  do {									      \
-    while (list != NULL) {						      \
-      struct block_list *old = list;					      \
-      list = list->next;						      \
-      free (old->address);						      \
-      free (old);							      \
-    }									      \
-  } while (0)
 # undef alloca
 # define alloca(size) (malloc (size))
 # define freea(p) free (p)
@@ -470,6 +598,175 @@ static int enable_secure;
 /* Get the function to evaluate the plural expression.  */
 #include "eval-plural.h"
 
+#ifndef IN_LIBGLOCALE
+/* Return the binding of DOMAINNAME, or NULL if it has none.  The caller
+   must hold _nl_state_lock.  */
+static struct binding *
+internal_function
+find_binding (const char *domainname)
+{
+  struct binding *binding;
+
+  for (binding = _nl_domain_bindings; binding != NULL; binding = binding->next)
+    {
+      int compare = strcmp (domainname, binding->domainname);
+      if (compare == 0)
+	/* We found it!  */
+	return binding;
+      if (compare < 0)
+	/* It is not in the list.  */
+	break;
+    }
+  return NULL;
+}
+#endif
+
+/* The search for the message catalogs of a domain, one for each language
+   of a colon separated list.  */
+struct catalog_search
+{
+  struct binding *binding;
+  /* Absolute name of the directory that contains the catalogs.  */
+  const char *dirname;
+  /* CATEGORYNAME/DOMAINNAME.mo.  */
+  char *xdomainname;
+  /* The languages not yet searched, and the current one.  */
+  const char *categoryvalue;
+  char *single_locale;
+  /* The malloc()ed memory of the strings above.  */
+  char *memory;
+};
+
+/* Prepare SEARCH to look for the DOMAINNAME catalogs of the category
+   CATEGORYNAME in DIRNAME, bound through BINDING, for the languages
+   CATEGORYVALUE.  Return 0, or -1 if the current working directory or
+   memory is not available.  The caller must hold _nl_state_lock.  */
+static int
+internal_function
+catalog_search_init (struct catalog_search *search, struct binding *binding,
+		     const char *dirname, const char *domainname,
+		     const char *categoryname, const char *categoryvalue)
+{
+  size_t domainname_len = strlen (domainname);
+  size_t xdomainname_size = strlen (categoryname) + domainname_len + 5;
+  size_t size = xdomainname_size + strlen (categoryvalue) + 1;
+  char *memory;
+
+  search->memory = NULL;
+
+  if (IS_ABSOLUTE_PATH (dirname))
+    {
+      memory = (char *) malloc (size);
+      if (memory == NULL)
+	return -1;
+    }
+  else
+    {
+      /* We have a relative path.  Make it absolute now.  */
+      size_t dirname_len = strlen (dirname) + 1;
+      size_t path_max;
+      char *resolved_dirname;
+      char *ret;
+
+      path_max = (unsigned int) PATH_MAX;
+      path_max += 2;		/* The getcwd docs say to do this.  */
+
+      for (;;)
+	{
+	  memory = (char *) malloc (size + path_max + dirname_len);
+	  if (memory == NULL)
+	    return -1;
+	  resolved_dirname = memory + size;
+
+	  __set_errno (0);
+	  ret = getcwd (resolved_dirname, path_max);
+	  if (ret != NULL || errno != ERANGE)
+	    break;
+
+	  free (memory);
+	  path_max += path_max / 2;
+	  path_max += PATH_INCR;
+	}
+
+      if (ret == NULL)
+	{
+	  free (memory);
+	  return -1;
+	}
+
+      stpcpy (stpcpy (strchr (resolved_dirname, '\0'), "/"), dirname);
+      dirname = resolved_dirname;
+    }
+
+  search->binding = binding;
+  search->dirname = dirname;
+  search->xdomainname = memory;
+  stpcpy ((char *) mempcpy (stpcpy (stpcpy (search->xdomainname,
+					      categoryname),
+				      "/"),
+			    domainname, domainname_len),
+	  ".mo");
+  search->categoryvalue = categoryvalue;
+  search->single_locale = memory + xdomainname_size;
+  search->memory = memory;
+  return 0;
+}
+
+/* Find the catalog for the next language of SEARCH.  Return 1 and store
+   the catalog, or NULL if there is none, in *DOMAINP.  Return 0 when all
+   languages have been searched.  */
+static int
+internal_function
+catalog_search_next (struct catalog_search *search,
+		     struct loaded_l10nfile **domainp)
+{
+  for (;;)
+    {
+      const char *categoryvalue = search->categoryvalue;
+      char *cp;
+
+      /* Make CATEGORYVALUE point to the next element of the list.  */
+      while (categoryvalue[0] == ':')
+	++categoryvalue;
+      if (categoryvalue[0] == '\0')
+	/* The whole contents of CATEGORYVALUE has been searched.  An
+	   implicit "C" entry follows, i.e. no translation will take
+	   place.  */
+	return 0;
+
+      cp = search->single_locale;
+      while (categoryvalue[0] != '\0' && categoryvalue[0] != ':')
+	*cp++ = *categoryvalue++;
+      *cp = '\0';
+      search->categoryvalue = categoryvalue;
+
+      /* When this is a SUID binary we must not allow accessing files
+	 outside the dedicated directories.  */
+      if (ENABLE_SECURE && IS_PATH_WITH_DIR (search->single_locale))
+	/* Ignore this entry.  */
+	continue;
+
+      /* If the locale value is C (or POSIX) no domain is loaded.  */
+      if (strcmp (search->single_locale, "C") == 0
+	  || strcmp (search->single_locale, "POSIX") == 0)
+	return 0;
+
+      /* Find structure describing the message catalog matching the
+	 DOMAINNAME and CATEGORY.  */
+      *domainp = _nl_find_domain (search->dirname, search->single_locale,
+				  search->xdomainname, search->binding);
+      return 1;
+    }
+}
+
+/* Free the memory of SEARCH.  */
+static void
+internal_function
+catalog_search_free (struct catalog_search *search)
+{
+  free (search->memory);
+}
+
 /* Look up MSGID in the DOMAINNAME message catalog for the current
    CATEGORY locale and, if PLURAL is nonzero, search over string
    depending on the plural form determined by N.  */
@@ -486,21 +783,16 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 	    int plural, unsigned long int n, int category)
 #endif
 {
-#ifndef HAVE_ALLOCA
-  struct block_list *block_list = NULL;
-#endif
   struct loaded_l10nfile *domain;
   struct binding *binding;
   const char *categoryname;
   const char *categoryvalue;
   const char *dirname;
-  char *xdomainname;
-  char *single_locale;
+  struct catalog_search search_catalogs;
   char *retval;
   size_t retlen;
   int saved_errno;
   struct known_translation_t search;
-  struct known_translation_t **foundp = NULL;
 #if defined HAVE_PER_THREAD_LOCALE && !defined IN_LIBGLOCALE
   const char *localename;
 #endif
@@ -568,18 +860,40 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
      tsearch calls can be fatal.  */
   gl_rwlock_rdlock (tree_lock);
 
-  foundp = (struct known_translation_t **) tfind (&search, &root, transcmp);
+  {
+    struct known_translation_t **foundp =
+      (struct known_translation_t **) tfind (&search, &root, transcmp);
+
+    if (foundp != NULL && (*foundp)->counter == _nl_msg_cat_cntr
+	&& (*foundp)->generation == (*foundp)->domaingen->generation)
+      {
+	/* Copy what we need while we hold the lock, because the entry
+	   can be evicted as soon as we release it.  The flag for the
+	   eviction hand matters only when the cache is limited.  It is
+	   cleared only while tree_lock is held for writing, therefore
+	   concurrent lookups can only store the same value here, and
+	   usually find it set already.  */
+	if (cache_limit != 0 && !(*foundp)->referenced)
+	  (*foundp)->referenced = 1;
+	domain = (*foundp)->domain;
+	retval = (char *) (*foundp)->translation;
+	retlen = (*foundp)->translation_length;
+	STATS_INCREMENT (cache_hits);
+      }
+    else
+      {
+	retval = NULL;
+	STATS_INCREMENT (cache_misses);
+      }
+  }
 
   gl_rwlock_unlock (tree_lock);
 
-  if (foundp != NULL && (*foundp)->counter == _nl_msg_cat_cntr)
+  if (retval != NULL)
     {
       /* Now deal with plural.  */
       if (plural)
-	retval = plural_lookup ((*foundp)->domain, n, (*foundp)->translation,
-				(*foundp)->translation_length);
-      else
-	retval = (char *) (*foundp)->translation;
+	retval = plural_lookup (domain, n, retval, retlen);
 
       gl_rwlock_unlock (_nl_state_lock);
 # ifdef _LIBC
@@ -600,61 +914,8 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
   binding = NULL;
   dirname = bindtextdomain (domainname, NULL);
 #else
-  for (binding = _nl_domain_bindings; binding != NULL; binding = binding->next)
-    {
-      int compare = strcmp (domainname, binding->domainname);
-      if (compare == 0)
-	/* We found it!  */
-	break;
-      if (compare < 0)
-	{
-	  /* It is not in the list.  */
-	  binding = NULL;
-	  break;
-	}
-    }
-
-  if (binding == NULL)
-    dirname = _nl_default_dirname;
-  else
-    {
-      dirname = binding->dirname;
-#endif
-      if (!IS_ABSOLUTE_PATH (dirname))
-	{
-	  /* We have a relative path.  Make it absolute now.  */
-	  size_t dirname_len = strlen (dirname) + 1;
-	  size_t path_max;
-	  char *resolved_dirname;
-	  char *ret;
-
-	  path_max = (unsigned int) PATH_MAX;
-	  path_max += 2;		/* The getcwd docs say to do this.  */
-
-	  for (;;)
-	    {
-	      resolved_dirname = (char *) alloca (path_max + dirname_len);
-	      ADD_BLOCK (block_list, tmp_dirname);
-
-	      __set_errno (0);
-	      ret = getcwd (resolved_dirname, path_max);
-	      if (ret != NULL || errno != ERANGE)
-		break;
-
-	      path_max += path_max / 2;
-	      path_max += PATH_INCR;
-	    }
-
-	  if (ret == NULL)
-	    /* We cannot get the current working directory.  Don't signal an
-	       error but simply return the default string.  */
-	    goto return_untranslated;
-
-	  stpcpy (stpcpy (strchr (resolved_dirname, '\0'), "/"), dirname);
-	  dirname = resolved_dirname;
-	}
-#ifndef IN_LIBGLOCALE
-    }
+  binding = find_binding (domainname);
+  dirname = (binding == NULL ? _nl_default_dirname : binding->dirname);
 #endif
 
   /* Now determine the symbolic name of CATEGORY and its value.  */
@@ -668,59 +929,17 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 #endif
 
   domainname_len = strlen (domainname);
-  xdomainname = (char *) alloca (strlen (categoryname)
-				 + domainname_len + 5);
-  ADD_BLOCK (block_list, xdomainname);
-
-  stpcpy ((char *) mempcpy (stpcpy (stpcpy (xdomainname, categoryname), "/"),
-			    domainname, domainname_len),
-	  ".mo");
-
-  /* Creating working area.  */
-  single_locale = (char *) alloca (strlen (categoryvalue) + 1);
-  ADD_BLOCK (block_list, single_locale);
 
+  if (catalog_search_init (&search_catalogs, binding, dirname, domainname,
+			   categoryname, categoryvalue) < 0)
+    /* We cannot get the current working directory.  Don't signal an
+       error but simply return the default string.  */
+    goto return_untranslated;
 
   /* Search for the given string.  This is a loop because we perhaps
      got an ordered list of languages to consider for the translation.  */
-  while (1)
+  while (catalog_search_next (&search_catalogs, &domain))
     {
-      /* Make CATEGORYVALUE point to the next element of the list.  */
-      while (categoryvalue[0] != '\0' && categoryvalue[0] == ':')
-	++categoryvalue;
-      if (categoryvalue[0] == '\0')
-	{
-	  /* The whole contents of CATEGORYVALUE has been searched but
-	     no valid entry has been found.  We solve this situation
-	     by implicitly appending a "C" entry, i.e. no translation
-	     will take place.  */
-	  single_locale[0] = 'C';
-	  single_locale[1] = '\0';
-	}
-      else
-	{
-	  char *cp = single_locale;
-	  while (categoryvalue[0] != '\0' && categoryvalue[0] != ':')
-	    *cp++ = *categoryvalue++;
-	  *cp = '\0';
-
-	  /* When this is a SUID binary we must not allow accessing files
-	     outside the dedicated directories.  */
-	  if (ENABLE_SECURE && IS_PATH_WITH_DIR (single_locale))
-	    /* Ingore this entry.  */
-	    continue;
-	}
-
-      /* If the current locale value is C (or POSIX) we don't load a
-	 domain.  Return the MSGID.  */
-      if (strcmp (single_locale, "C") == 0
-	  || strcmp (single_locale, "POSIX") == 0)
-	break;
-
-      /* Find structure describing the message catalog matching the
-	 DOMAINNAME and CATEGORY.  */
-      domain = _nl_find_domain (dirname, single_locale, xdomainname, binding);
-
       if (domain != NULL)
 	{
 #if defined IN_LIBGLOCALE
@@ -766,71 +985,89 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 	    {
 	      /* Found the translation of MSGID1 in domain DOMAIN:
 		 starting at RETVAL, RETLEN bytes.  */
-	      FREE_BLOCKS (block_list);
-	      if (foundp == NULL)
-		{
-		  /* Create a new entry and add it to the search tree.  */
-		  size_t msgid_len;
-		  size_t size;
-		  struct known_translation_t *newp;
-
-		  msgid_len = strlen (msgid1) + 1;
-		  size = offsetof (struct known_translation_t, msgid)
-			 + msgid_len + domainname_len + 1;
+	      catalog_search_free (&search_catalogs);
+	      {
+		/* Create a new entry and add it to the search tree.  */
+		size_t msgid_len;
+		size_t size;
+		struct known_translation_t *newp;
+
+		msgid_len = strlen (msgid1) + 1;
+		size = offsetof (struct known_translation_t, msgid)
+		       + msgid_len + domainname_len + 1;
 #ifdef HAVE_PER_THREAD_LOCALE
-		  size += strlen (localename) + 1;
+		size += strlen (localename) + 1;
 #endif
-		  newp = (struct known_translation_t *) malloc (size);
-		  if (newp != NULL)
-		    {
-		      char *new_domainname;
+		newp = (struct known_translation_t *) malloc (size);
+		if (newp != NULL)
+		  {
+		    char *new_domainname;
 #ifdef HAVE_PER_THREAD_LOCALE
-		      char *new_localename;
+		    char *new_localename;
 #endif
 
-		      new_domainname =
-			(char *) mempcpy (newp->msgid.appended, msgid1,
-					  msgid_len);
-		      memcpy (new_domainname, domainname, domainname_len + 1);
+		    new_domainname =
+		      (char *) mempcpy (newp->msgid.appended, msgid1,
+					msgid_len);
+		    memcpy (new_domainname, domainname, domainname_len + 1);
 #ifdef HAVE_PER_THREAD_LOCALE
-		      new_localename = new_domainname + domainname_len + 1;
-		      strcpy (new_localename, localename);
+		    new_localename = new_domainname + domainname_len + 1;
+		    strcpy (new_localename, localename);
 #endif
-		      newp->domainname = new_domainname;
-		      newp->category = category;
+		    newp->domainname = new_domainname;
+		    newp->category = category;
 #ifdef HAVE_PER_THREAD_LOCALE
-		      newp->localename = new_localename;
+		    newp->localename = new_localename;
 #endif
 #ifdef IN_LIBGLOCALE
-		      newp->encoding = encoding;
-#endif
-		      newp->counter = _nl_msg_cat_cntr;
-		      newp->domain = domain;
-		      newp->translation = retval;
-		      newp->translation_length = retlen;
-
-		      gl_rwlock_wrlock (tree_lock);
-
-		      /* Insert the entry in the search tree.  */
-		      foundp = (struct known_translation_t **)
-			tsearch (newp, &root, transcmp);
-
-		      gl_rwlock_unlock (tree_lock);
-
-		      if (foundp == NULL
-			  || __builtin_expect (*foundp != newp, 0))
-			/* The insert failed.  */
-			free (newp);
-		    }
-		}
-	      else
-		{
-		  /* We can update the existing entry.  */
-		  (*foundp)->counter = _nl_msg_cat_cntr;
-		  (*foundp)->domain = domain;
-		  (*foundp)->translation = retval;
-		  (*foundp)->translation_length = retlen;
-		}
+		    newp->encoding = encoding;
+#endif
+		    newp->counter = _nl_msg_cat_cntr;
+		    newp->domain = domain;
+		    newp->translation = retval;
+		    newp->translation_length = retlen;
+
+		    gl_rwlock_wrlock (tree_lock);
+
+		    newp->domaingen = get_domain_generation (new_domainname);
+		    if (newp->domaingen != NULL)
+		      {
+			struct known_translation_t **foundp;
+
+			newp->generation = newp->domaingen->generation;
+
+			/* Insert the entry in the search tree.  */
+			foundp = (struct known_translation_t **)
+			  tsearch (newp, &root, transcmp);
+
+			if (foundp == NULL)
+			  /* The insert failed.  */
+			  ;
+			else if (*foundp == newp)
+			  {
+			    clock_insert (newp);
+			    if (cache_limit > 0)
+			      clock_evict (cache_limit);
+			    newp = NULL;
+			  }
+			else
+			  {
+			    /* An outdated entry exists.  We can update it.  */
+			    (*foundp)->counter = newp->counter;
+			    (*foundp)->generation = newp->generation;
+			    (*foundp)->domain = domain;
+			    (*foundp)->translation = retval;
+			    (*foundp)->translation_length = retlen;
+			    (*foundp)->referenced = 1;
+			  }
+		      }
+
+		    gl_rwlock_unlock (tree_lock);
+
+		    /* Free the entry if it was not added to the tree.  */
+		    free (newp);
+		  }
+	      }
 
 	      __set_errno (saved_errno);
 
@@ -849,7 +1086,7 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 
  return_untranslated:
   /* Return the untranslated MSGID.  */
-  FREE_BLOCKS (block_list);
+  catalog_search_free (&search_catalogs);
   gl_rwlock_unlock (_nl_state_lock);
 #ifdef _LIBC
   __libc_rwlock_unlock (__libc_setlocale_lock);
@@ -875,6 +1112,547 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 }
 
 
+#ifndef IN_LIBGLOCALE
+/* Names for the libintl functions are a problem.  See above.  */
+# ifdef _LIBC
+#  define TEXTDOMAIN_PRELOAD __textdomain_preload
+#  define TEXTDOMAIN_RELOAD __textdomain_reload
+#  define TEXTDOMAIN_CACHE_LIMIT __textdomain_cache_limit
+#  define TEXTDOMAIN_CACHE_STATS __textdomain_cache_stats
+#  define TEXTDOMAIN_CONTEXT_NEW __textdomain_context_new
+#  define TEXTDOMAIN_CONTEXT_FREE __textdomain_context_free
+#  define TEXTDOMAIN_CONTEXT_GETTEXT __textdomain_context_gettext
+#  define TEXTDOMAIN_CONTEXT_NGETTEXT __textdomain_context_ngettext
+# else
+#  define TEXTDOMAIN_PRELOAD libintl_textdomain_preload
+#  define TEXTDOMAIN_RELOAD libintl_textdomain_reload
+#  define TEXTDOMAIN_CACHE_LIMIT libintl_textdomain_cache_limit
+#  define TEXTDOMAIN_CACHE_STATS libintl_textdomain_cache_stats
+#  define TEXTDOMAIN_CONTEXT_NEW libintl_textdomain_context_new
+#  define TEXTDOMAIN_CONTEXT_FREE libintl_textdomain_context_free
+#  define TEXTDOMAIN_CONTEXT_GETTEXT libintl_textdomain_context_gettext
+#  define TEXTDOMAIN_CONTEXT_NGETTEXT libintl_textdomain_context_ngettext
+# endif
+
+/* Load DOMAIN_FILE, if not yet done, and prepare it for lookups: set up
+   the charset conversion for DOMAINBINDING and fault in its pages.
+   Return 1 if DOMAIN_FILE contains a valid message catalog, 0 otherwise.  */
+static int
+internal_function
+preload_domain (struct loaded_l10nfile *domain_file,
+		struct binding *domainbinding)
+{
+  size_t len;
+
+  if (domain_file->decided <= 0)
+    _nl_load_domain (domain_file, domainbinding);
+
+  if (domain_file->data == NULL)
+    return 0;
+
+  /* Looking up the header entry with conversion enabled opens the
+     conversion descriptor and allocates the table of converted strings,
+     which the first gettext() call would otherwise do.  */
+  (void) _nl_find_msg (domain_file, domainbinding, "", 1, &len);
+
+  _nl_prefault_domain (domain_file);
+  return 1;
+}
+
+/* Load the DOMAINNAME message catalogs for the current CATEGORY locale,
+   as DCIGETTEXT would do it lazily, and return the number of catalogs
+   that were found.  */
+int
+TEXTDOMAIN_PRELOAD (const char *domainname, int category)
+{
+  struct loaded_l10nfile *domain;
+  struct binding *binding;
+  const char *categoryname;
+  struct catalog_search search_catalogs;
+  int saved_errno;
+  int loaded;
+
+#ifdef _LIBC
+  if (category < 0 || category >= __LC_LAST || category == LC_ALL)
+    /* Bogus.  */
+    return 0;
+#endif
+
+  /* Preserve the `errno' value.  */
+  saved_errno = errno;
+  loaded = 0;
+
+#ifdef _LIBC
+  __libc_rwlock_define (extern, __libc_setlocale_lock attribute_hidden)
+  __libc_rwlock_rdlock (__libc_setlocale_lock);
+#endif
+
+  gl_rwlock_rdlock (_nl_state_lock);
+
+  if (domainname == NULL)
+    domainname = _nl_current_default_domain;
+
+#ifdef LC_MESSAGES_COMPAT
+  if (category == LC_MESSAGES_COMPAT)
+    category = LC_MESSAGES;
+#endif
+
+  /* See whether this is a SUID binary or not.  */
+  DETERMINE_SECURE;
+
+  /* Search the catalogs in the same way as DCIGETTEXT, so that it finds
+     the catalogs loaded here.  */
+  binding = find_binding (domainname);
+  categoryname = category_to_name (category);
+  if (catalog_search_init (&search_catalogs, binding,
+			   binding == NULL
+			   ? _nl_default_dirname : binding->dirname,
+			   domainname, categoryname,
+			   guess_category_value (category, categoryname)) < 0)
+    goto out;
+
+  /* Load the catalogs of all languages in the list.  DCIGETTEXT falls
+     back to the later ones for messages that the earlier ones lack.  */
+  while (catalog_search_next (&search_catalogs, &domain))
+    if (domain != NULL)
+      {
+	int cnt;
+
+	loaded += preload_domain (domain, binding);
+	for (cnt = 0; domain->successor[cnt] != NULL; ++cnt)
+	  loaded += preload_domain (domain->successor[cnt], binding);
+      }
+
+  catalog_search_free (&search_catalogs);
+
+ out:
+  gl_rwlock_unlock (_nl_state_lock);
+#ifdef _LIBC
+  __libc_rwlock_unlock (__libc_setlocale_lock);
+#endif
+  __set_errno (saved_errno);
+  return loaded;
+}
+
+/* Serializes the reloads, so that two reloads never replace the same
+   catalog.  */
+gl_lock_define_initialized (static, reload_lock)
+
+/* Look whether the files of the loaded DOMAINNAME message catalogs have
+   changed, and load the new contents of those that have.  Only the known
+   translations of DOMAINNAME are invalidated.  Return the number of
+   catalogs that were replaced.  */
+int
+TEXTDOMAIN_RELOAD (const char *domainname)
+{
+  int saved_errno;
+  char *default_domain = NULL;
+  struct reloaded_domain *reloaded;
+  int count;
+
+  /* Preserve the `errno' value.  */
+  saved_errno = errno;
+
+  gl_lock_lock (reload_lock);
+
+  if (domainname == NULL)
+    {
+      gl_rwlock_rdlock (_nl_state_lock);
+      default_domain = strdup (_nl_current_default_domain);
+      gl_rwlock_unlock (_nl_state_lock);
+      if (default_domain == NULL)
+	{
+	  gl_lock_unlock (reload_lock);
+	  __set_errno (saved_errno);
+	  return 0;
+	}
+      domainname = default_domain;
+    }
+
+  /* The catalog list files may have been updated along with the
+     catalogs.  */
+  _nl_forget_catalog_lists ();
+
+  /* Read the new files while the lookups go on in the old catalogs.  */
+  count = _nl_reload_domains (domainname, &reloaded);
+
+  if (count > 0)
+    {
+      struct domain_generation *domaingen;
+      int i;
+
+      /* Exclude all lookups while the catalogs are replaced and the
+	 generation is incremented.  Otherwise a lookup that found its
+	 translation in an old catalog could enter it into the cache under
+	 the new generation.  */
+      gl_rwlock_wrlock (_nl_state_lock);
+
+      for (i = 0; i < count; i++)
+	reloaded[i].domain_file->data = reloaded[i].data;
+
+      gl_rwlock_wrlock (tree_lock);
+
+      domaingen = get_domain_generation (domainname);
+      if (domaingen != NULL)
+	++domaingen->generation;
+      else
+	/* Out of memory.  Fall back to invalidating all known
+	   translations.  */
+	++_nl_msg_cat_cntr;
+
+      gl_rwlock_unlock (tree_lock);
+      gl_rwlock_unlock (_nl_state_lock);
+
+      free (reloaded);
+    }
+
+  gl_lock_unlock (reload_lock);
+  free (default_domain);
+  __set_errno (saved_errno);
+  return count;
+}
+
+/* Limit the number of known translations that are kept to LIMIT, or
+   remove the limit if LIMIT is 0.  Return the previous limit.  */
+unsigned long int
+TEXTDOMAIN_CACHE_LIMIT (unsigned long int limit)
+{
+  unsigned long int old_limit;
+
+  gl_rwlock_wrlock (tree_lock);
+
+  old_limit = cache_limit;
+  cache_limit = limit;
+  if (limit > 0)
+    clock_evict (limit);
+
+  gl_rwlock_unlock (tree_lock);
+
+  return old_limit;
+}
+
+/* Store the statistics about the known translations in *STATS.  */
+void
+TEXTDOMAIN_CACHE_STATS (struct textdomain_cache_info *stats)
+{
+  gl_rwlock_rdlock (tree_lock);
+
+  stats->entries = cache_entries;
+  stats->limit = cache_limit;
+  stats->hits = STATS_READ (cache_hits);
+  stats->misses = STATS_READ (cache_misses);
+  stats->evictions = cache_evictions;
+
+  gl_rwlock_unlock (tree_lock);
+}
+
+/* A translation context: the message catalogs of a domain for a given
+   list of languages, determined once so that lookups through the context
+   need not determine the locale and search the loaded catalogs again.  */
+struct textdomain_context
+{
+  /* The domain, the category and the colon separated list of languages.  */
+  char *domainname;
+  int category;
+  char *localename;
+
+  /* Value of _nl_msg_cat_cntr when the catalogs were determined.  */
+  int counter;
+
+  /* Binding of the domain at that time.  */
+  struct binding *binding;
+
+  /* The catalogs of the languages, in the order of the list.  */
+  struct loaded_l10nfile **domains;
+  size_t ndomains;
+};
+
+/* Determine the message catalogs of the context CTX.  The caller must
+   hold _nl_state_lock.  */
+static void
+internal_function
+context_resolve (struct textdomain_context *ctx)
+{
+  struct catalog_search search_catalogs;
+  struct loaded_l10nfile *domain;
+
+  ctx->counter = _nl_msg_cat_cntr;
+  ctx->binding = find_binding (ctx->domainname);
+  ctx->ndomains = 0;
+
+  if (catalog_search_init (&search_catalogs, ctx->binding,
+			   ctx->binding == NULL
+			   ? _nl_default_dirname : ctx->binding->dirname,
+			   ctx->domainname, category_to_name (ctx->category),
+			   ctx->localename) < 0)
+    return;
+
+  while (catalog_search_next (&search_catalogs, &domain))
+    if (domain != NULL)
+      ctx->domains[ctx->ndomains++] = domain;
+
+  catalog_search_free (&search_catalogs);
+}
+
+/* Create a translation context for DOMAINNAME and the list of languages
+   LOCALENAME, or the current locale of CATEGORY if LOCALENAME is NULL.
+   Return NULL if out of memory.  */
+struct textdomain_context *
+TEXTDOMAIN_CONTEXT_NEW (const char *domainname, int category,
+			const char *localename)
+{
+  struct textdomain_context *ctx;
+  size_t nlanguages;
+  const char *p;
+  int saved_errno;
+
+#ifdef _LIBC
+  if (category < 0 || category >= __LC_LAST || category == LC_ALL)
+    /* Bogus.  */
+    return NULL;
+#endif
+
+  /* Preserve the `errno' value.  */
+  saved_errno = errno;
+
+#ifdef _LIBC
+  __libc_rwlock_define (extern, __libc_setlocale_lock attribute_hidden)
+  __libc_rwlock_rdlock (__libc_setlocale_lock);
+#endif
+
+  gl_rwlock_rdlock (_nl_state_lock);
+
+  if (domainname == NULL)
+    domainname = _nl_current_default_domain;
+
+#ifdef LC_MESSAGES_COMPAT
+  if (category == LC_MESSAGES_COMPAT)
+    category = LC_MESSAGES;
+#endif
+
+  /* See whether this is a SUID binary or not.  */
+  DETERMINE_SECURE;
+
+  if (localename == NULL)
+    localename = guess_category_value (category, category_to_name (category));
+
+  ctx = (struct textdomain_context *) malloc (sizeof (*ctx));
+  if (ctx == NULL)
+    goto out;
+
+  nlanguages = 1;
+  for (p = localename; *p != '\0'; p++)
+    if (*p == ':')
+      nlanguages++;
+
+  ctx->domainname = strdup (domainname);
+  ctx->category = category;
+  ctx->localename = strdup (localename);
+  ctx->domains = (struct loaded_l10nfile **)
+    malloc (nlanguages * sizeof (struct loaded_l10nfile *));
+  if (ctx->domainname == NULL || ctx->localename == NULL
+      || ctx->domains == NULL)
+    {
+      free (ctx->domains);
+      free (ctx->localename);
+      free (ctx->domainname);
+      free (ctx);
+      ctx = NULL;
+      goto out;
+    }
+
+  context_resolve (ctx);
+
+ out:
+  gl_rwlock_unlock (_nl_state_lock);
+#ifdef _LIBC
+  __libc_rwlock_unlock (__libc_setlocale_lock);
+#endif
+  __set_errno (saved_errno);
+  return ctx;
+}
+
+/* Free the translation context CTX.  */
+void
+TEXTDOMAIN_CONTEXT_FREE (struct textdomain_context *ctx)
+{
+  if (ctx != NULL)
+    {
+      free (ctx->domains);
+      free (ctx->localename);
+      free (ctx->domainname);
+      free (ctx);
+    }
+}
+
+/* Look up MSGID1, and MSGID2 for PLURAL, in the catalogs of the context
+   CTX.  */
+static char *
+internal_function
+context_lookup (struct textdomain_context *ctx, const char *msgid1,
+		const char *msgid2, int plural, unsigned long int n)
+{
+  char *retval = NULL;
+  size_t retlen;
+  size_t i;
+  int saved_errno;
+
+  /* If no real MSGID is given return NULL.  */
+  if (msgid1 == NULL)
+    return NULL;
+
+  /* Preserve the `errno' value.  */
+  saved_errno = errno;
+
+  gl_rwlock_rdlock (_nl_state_lock);
+
+  /* A change of the bindings or of the loaded catalogs makes the
+     catalogs determined earlier outdated.  */
+  if (ctx->counter != _nl_msg_cat_cntr)
+    context_resolve (ctx);
+
+  for (i = 0; i < ctx->ndomains; i++)
+    {
+      struct loaded_l10nfile *domain = ctx->domains[i];
+      int cnt;
+
+      retval = _nl_find_msg (domain, ctx->binding, msgid1, 1, &retlen);
+
+      for (cnt = 0;
+	   retval == NULL && ctx->domains[i]->successor[cnt] != NULL;
+	   ++cnt)
+	{
+	  domain = ctx->domains[i]->successor[cnt];
+	  retval = _nl_find_msg (domain, ctx->binding, msgid1, 1, &retlen);
+	}
+
+      /* Returning -1 means that some resource problem exists
+	 (likely memory) and that the strings could not be
+	 converted.  Return the original strings.  */
+      if (__builtin_expect (retval == (char *) -1, 0))
+	{
+	  retval = NULL;
+	  break;
+	}
+
+      if (retval != NULL)
+	{
+	  /* Now deal with plural.  */
+	  if (plural)
+	    retval = plural_lookup (domain, n, retval, retlen);
+	  break;
+	}
+    }
+
+  gl_rwlock_unlock (_nl_state_lock);
+  __set_errno (saved_errno);
+
+  if (retval != NULL)
+    return retval;
+
+  /* Return the untranslated MSGID.  */
+  return (plural == 0
+	  ? (char *) msgid1
+	  /* Use the Germanic plural rule.  */
+	  : n == 1 ? (char *) msgid1 : (char *) msgid2);
+}
+
+/* Look up MSGID in the catalogs of the context CTX.  */
+char *
+TEXTDOMAIN_CONTEXT_GETTEXT (struct textdomain_context *ctx, const char *msgid)
+{
+  return context_lookup (ctx, msgid, NULL, 0, 0);
+}
+
+/* Look up the plural form for N of MSGID1 and MSGID2 in the catalogs of
+   the context CTX.  */
+char *
+TEXTDOMAIN_CONTEXT_NGETTEXT (struct textdomain_context *ctx,
+			     const char *msgid1, const char *msgid2,
+			     unsigned long int n)
+{
+  return context_lookup (ctx, msgid1, msgid2, 1, n);
+}
+#endif
+
+
+/* Return the translated string of LENGTH bytes, including the trailing NUL,
+   at OFFSET in the compressed blocks of DOMAIN.  The block that contains it
+   is uncompressed when it is first needed, and stays in memory, because
+   the strings returned from it may still be in use.  Return NULL if the
+   message catalog is damaged, or (char *) -1 in case of a memory
+   allocation failure.  */
+static char *
+internal_function
+find_compressed_string (struct loaded_domain *domain, nls_uint32 offset,
+			size_t length)
+{
+  const struct compressed_block *block;
+  nls_uint32 start;
+  nls_uint32 size;
+  size_t bottom, top, act;
+  char *block_data;
+
+  /* Binary search in the blocks, which are sorted by start.  */
+  bottom = 0;
+  top = domain->n_blocks;
+  while (bottom < top)
+    {
+      act = (bottom + top) / 2;
+      if (offset < W (domain->must_swap, domain->blocks[act].start))
+	top = act;
+      else
+	bottom = act + 1;
+    }
+  if (bottom == 0)
+    return NULL;
+  act = bottom - 1;
+
+  block = &domain->blocks[act];
+  start = W (domain->must_swap, block->start);
+  size = W (domain->must_swap, block->size);
+  if (offset - start > size || length > size - (offset - start))
+    return NULL;
+
+  gl_rwlock_rdlock (domain->blocks_lock);
+  block_data = domain->block_data[act];
+  gl_rwlock_unlock (domain->blocks_lock);
+
+  if (block_data == NULL)
+    {
+      gl_rwlock_wrlock (domain->blocks_lock);
+      /* Maybe in the meantime somebody uncompressed the block.  Recheck.  */
+      block_data = domain->block_data[act];
+      if (block_data == NULL)
+	{
+	  block_data = (char *) malloc (size);
+	  if (__builtin_expect (block_data == NULL, 0))
+	    {
+	      gl_rwlock_unlock (domain->blocks_lock);
+	      return (char *) -1;
+	    }
+	  if (__lz_block_decode (domain->data
+				 + W (domain->must_swap, block->offset),
+				 W (domain->must_swap, block->length),
+				 block_data, size) < 0)
+	    {
+	      gl_rwlock_unlock (domain->blocks_lock);
+	      free (block_data);
+	      return NULL;
+	    }
+	  domain->block_data[act] = block_data;
+	}
+      gl_rwlock_unlock (domain->blocks_lock);
+    }
+
+  /* The string must be NUL terminated.  */
+  if (length == 0 || block_data[offset - start + length - 1] != '\0')
+    return NULL;
+
+  return block_data + (offset - start);
+}
+
+
 /* Look up the translation of msgid within DOMAIN_FILE and DOMAINBINDING.
    Return it if found.  Return NULL if not found or in case of a conversion
    failure (problem in the particular message catalog).  Return (char *) -1
@@ -911,7 +1689,35 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
   nstrings = domain->nstrings;
 
   /* Locate the MSGID and its translation.  */
-  if (domain->hash_tab != NULL)
+  if (domain->phash_displ != NULL)
+    {
+      /* Use the perfect hash table.  Only one original string needs to be
+	 compared with MSGID.  */
+      nls_uint32 len = strlen (msgid);
+      nls_uint32 fnv_hash_val = __hash_string_fnv (msgid);
+      nls_uint32 displ =
+	W (domain->must_swap,
+	   domain->phash_displ[fnv_hash_val % domain->phash_n_buckets]);
+      nls_uint32 slot =
+	__hash_string_slot (__hash_string (msgid), fnv_hash_val, displ)
+	% nstrings;
+      nls_uint32 nstr = W (domain->must_swap, domain->phash_tab[slot]);
+
+      /* We compare the lengths with >=, not ==, because plural entries
+	 are represented by strings with an embedded NUL.  */
+      if (nstr < nstrings
+	  && W (domain->must_swap, domain->orig_tab[nstr].length) >= len
+	  && (strcmp (msgid,
+		      domain->data + W (domain->must_swap,
+					domain->orig_tab[nstr].offset))
+	      == 0))
+	{
+	  act = nstr;
+	  goto found;
+	}
+      return NULL;
+    }
+  else if (domain->hash_tab != NULL)
     {
       /* Use the hashing table.  */
       nls_uint32 len = strlen (msgid);
@@ -987,9 +1793,18 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
      string to use a different character set, this is the time.  */
   if (act < nstrings)
     {
-      result = (char *)
-	(domain->data + W (domain->must_swap, domain->trans_tab[act].offset));
+      nls_uint32 offset =
+	W (domain->must_swap, domain->trans_tab[act].offset);
+
       resultlen = W (domain->must_swap, domain->trans_tab[act].length) + 1;
+      if (domain->blocks != NULL)
+	{
+	  result = find_compressed_string (domain, offset, resultlen);
+	  if (result == NULL || result == (char *) -1)
+	    return result;
+	}
+      else
+	result = (char *) (domain->data + offset);
     }
   else
     {
@@ -1708,6 +2523,17 @@ libc_freeres_fn (free_mem)
   /* Remove the search tree with the known translations.  */
   __tdestroy (root, free);
   root = NULL;
+  clock_hand = NULL;
+  cache_entries = 0;
+
+  /* Remove the versions of the text domains, which the entries of the
+     search tree pointed to.  */
+  while (domain_generations != NULL)
+    {
+      struct domain_generation *oldp = domain_generations;
+      domain_generations = domain_generations->next;
+      free (oldp);
+    }
 
   while (transmem_list != NULL)
     {
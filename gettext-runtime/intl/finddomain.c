@@ -50,6 +50,267 @@
 /* List of already loaded domains.  */
 static struct loaded_l10nfile *_nl_loaded_domains;
 
+/* We need to protect modifying the _NL_LOADED_DOMAINS data.  */
+gl_rwlock_define_initialized (static, lock)
+
+/* Name of the file, in a directory of message catalogs, that lists the
+   message catalogs present in that directory.  */
+#define CATALOG_LIST_FILE "catalogs.lst"
+
+/* Contents of the catalog list file of a directory.  */
+struct catalog_list
+{
+  struct catalog_list *next;
+  /* Sorted file names of the catalogs, relative to DIRNAME, or NULL if
+     the directory has no catalog list file.  */
+  char **names;
+  size_t nnames;
+  char *contents;
+  char dirname[ZERO];
+};
+
+/* List of the directories whose catalog list file was looked at.
+   Protected by lock.  */
+static struct catalog_list *catalog_lists;
+
+
+static int
+catalog_name_compare (const void *p1, const void *p2)
+{
+  return strcmp (*(const char *const *) p1, *(const char *const *) p2);
+}
+
+/* Read the catalog list file of DIRNAME.  Return NULL if out of memory.  */
+static struct catalog_list *
+internal_function
+read_catalog_list (const char *dirname)
+{
+  size_t dirname_len = strlen (dirname);
+  struct catalog_list *list;
+  char *file_name;
+  FILE *fp;
+  size_t size;
+  size_t allocated;
+  char *p;
+
+  list = (struct catalog_list *)
+    malloc (offsetof (struct catalog_list, dirname) + dirname_len + 1);
+  if (list == NULL)
+    return NULL;
+  memcpy (list->dirname, dirname, dirname_len + 1);
+  list->names = NULL;
+  list->nnames = 0;
+  list->contents = NULL;
+
+  file_name = (char *) malloc (dirname_len + 1 + sizeof CATALOG_LIST_FILE);
+  if (file_name == NULL)
+    {
+      free (list);
+      return NULL;
+    }
+  memcpy (file_name, dirname, dirname_len);
+  file_name[dirname_len] = '/';
+  memcpy (file_name + dirname_len + 1, CATALOG_LIST_FILE,
+	  sizeof CATALOG_LIST_FILE);
+
+  fp = fopen (file_name, "r");
+  free (file_name);
+  if (fp == NULL)
+    /* The directory has no catalog list file.  All catalogs may exist.  */
+    return list;
+
+  /* Read the whole file.  */
+  size = 0;
+  allocated = 0;
+  for (;;)
+    {
+      size_t n;
+
+      if (size + 1 >= allocated)
+	{
+	  char *new_contents;
+
+	  allocated = 2 * allocated + 1024;
+	  new_contents = (char *) realloc (list->contents, allocated);
+	  if (new_contents == NULL)
+	    goto fail;
+	  list->contents = new_contents;
+	}
+      n = fread (list->contents + size, 1, allocated - 1 - size, fp);
+      if (n == 0)
+	break;
+      size += n;
+    }
+  if (ferror (fp))
+    goto fail;
+  fclose (fp);
+  fp = NULL;
+  list->contents[size] = '\0';
+
+  /* Split it into lines.  Empty lines and lines starting with '#' are
+     ignored.  */
+  list->names = (char **) malloc ((size / 2 + 1) * sizeof (char *));
+  if (list->names == NULL)
+    goto fail;
+  for (p = list->contents; *p != '\0'; )
+    {
+      char *line = p;
+      char *end = strchr (p, '\n');
+
+      if (end != NULL)
+	{
+	  *end = '\0';
+	  p = end + 1;
+	}
+      else
+	{
+	  end = line + strlen (line);
+	  p = end;
+	}
+      if (end > line && end[-1] == '\r')
+	*--end = '\0';
+      if (line[0] == '.' && line[1] == '/')
+	line += 2;
+      if (line[0] != '\0' && line[0] != '#')
+	list->names[list->nnames++] = line;
+    }
+  qsort (list->names, list->nnames, sizeof (char *), catalog_name_compare);
+
+  return list;
+
+ fail:
+  if (fp != NULL)
+    fclose (fp);
+  free (list->names);
+  free (list->contents);
+  free (list);
+  return NULL;
+}
+
+/* Free the catalog list LIST.  */
+static void
+internal_function
+free_catalog_list (struct catalog_list *list)
+{
+  free (list->names);
+  free (list->contents);
+  free (list);
+}
+
+/* Return the catalog list of DIRNAME, or NULL if it has not been read yet.
+   The caller must hold lock.  */
+static struct catalog_list *
+internal_function
+lookup_catalog_list (const char *dirname)
+{
+  struct catalog_list *list;
+
+  for (list = catalog_lists; list != NULL; list = list->next)
+    if (strcmp (list->dirname, dirname) == 0)
+      break;
+  return list;
+}
+
+/* Mark DOMAIN_FILE and its successors as missing, without trying to open
+   them, if the catalog list LIST of DIRNAME does not mention them.  The
+   caller must hold lock.  */
+static void
+internal_function
+skip_unlisted (const struct catalog_list *list, const char *dirname,
+	       struct loaded_l10nfile *domain_file)
+{
+  size_t dirname_len;
+  int cnt;
+
+  if (list->names == NULL)
+    return;
+
+  dirname_len = strlen (dirname);
+
+  for (cnt = -1; cnt < 0 || domain_file->successor[cnt] != NULL; ++cnt)
+    {
+      struct loaded_l10nfile *runp =
+	(cnt < 0 ? domain_file : domain_file->successor[cnt]);
+
+      if (runp->decided == 0 && runp->filename != NULL
+	  && strncmp (runp->filename, dirname, dirname_len) == 0
+	  && runp->filename[dirname_len] == '/')
+	{
+	  const char *name = runp->filename + dirname_len + 1;
+
+	  if (bsearch (&name, list->names, list->nnames, sizeof (char *),
+		       catalog_name_compare) == NULL)
+	    _nl_skip_domain (runp);
+	}
+    }
+}
+
+/* Mark DOMAIN_FILE and its successors as missing, without trying to open
+   them, if the catalog list file of DIRNAME does not mention them.  */
+static void
+internal_function
+skip_unlisted_catalogs (const char *dirname,
+			struct loaded_l10nfile *domain_file)
+{
+  struct catalog_list *list;
+  struct catalog_list *new_list;
+  int cnt;
+
+  /* Nothing to do if all of them were already looked at.  */
+  for (cnt = -1; cnt < 0 || domain_file->successor[cnt] != NULL; ++cnt)
+    if ((cnt < 0 ? domain_file : domain_file->successor[cnt])->decided == 0)
+      break;
+  if (cnt >= 0 && domain_file->successor[cnt] == NULL)
+    return;
+
+  /* The list is used while the lock is held, because
+     _nl_forget_catalog_lists may free it at any other time.  */
+  gl_rwlock_rdlock (lock);
+  list = lookup_catalog_list (dirname);
+  if (list != NULL)
+    skip_unlisted (list, dirname, domain_file);
+  gl_rwlock_unlock (lock);
+
+  if (list != NULL)
+    return;
+
+  new_list = read_catalog_list (dirname);
+  if (new_list == NULL)
+    return;
+
+  gl_rwlock_wrlock (lock);
+  /* Another thread may have read it meanwhile.  */
+  list = lookup_catalog_list (dirname);
+  if (list == NULL)
+    {
+      new_list->next = catalog_lists;
+      catalog_lists = new_list;
+      list = new_list;
+      new_list = NULL;
+    }
+  skip_unlisted (list, dirname, domain_file);
+  gl_rwlock_unlock (lock);
+
+  if (new_list != NULL)
+    free_catalog_list (new_list);
+}
+
+/* Forget the catalog list files read so far, so that they are read again
+   when catalogs are looked for in their directories.  */
+void
+internal_function
+_nl_forget_catalog_lists (void)
+{
+  gl_rwlock_wrlock (lock);
+  while (catalog_lists != NULL)
+    {
+      struct catalog_list *here = catalog_lists;
+      catalog_lists = catalog_lists->next;
+      free_catalog_list (here);
+    }
+  gl_rwlock_unlock (lock);
+}
+
 
 /* Return a data structure describing the message catalog described by
    the DOMAINNAME and CATEGORY parameters with respect to the currently
@@ -82,8 +343,6 @@ _nl_find_domain (const char *dirname, char *locale,
 		(4) modifier
    */
 
-  /* We need to protect modifying the _NL_LOADED_DOMAINS data.  */
-  gl_rwlock_define_initialized (static, lock);
   gl_rwlock_rdlock (lock);
 
   /* If we have already tested for this locale entry there has to
@@ -99,6 +358,8 @@ _nl_find_domain (const char *dirname, char *locale,
       /* We know something about this locale.  */
       int cnt;
 
+      skip_unlisted_catalogs (dirname, retval);
+
       if (retval->decided <= 0)
 	_nl_load_domain (retval, domainbinding);
 
@@ -162,6 +423,8 @@ _nl_find_domain (const char *dirname, char *locale,
     /* This means we are out of core.  */
     goto out;
 
+  skip_unlisted_catalogs (dirname, retval);
+
   if (retval->decided <= 0)
     _nl_load_domain (retval, domainbinding);
   if (retval->data == NULL)
@@ -189,6 +452,95 @@ out:
 }
 
 
+/* Return 1 if FILENAME, of the form DIRNAME/LOCALE/CATEGORY/DOMAIN.mo,
+   is a catalog of DOMAINNAME.  */
+static int
+is_catalog_of (const char *filename, const char *domainname,
+	       size_t domainname_len)
+{
+  size_t len = strlen (filename);
+
+  return (len > domainname_len + 4
+	  && filename[len - domainname_len - 4] == '/'
+	  && memcmp (filename + len - domainname_len - 3,
+		     domainname, domainname_len) == 0
+	  && strcmp (filename + len - 3, ".mo") == 0);
+}
+
+/* Load anew every message catalog of DOMAINNAME that has been loaded so
+   far and whose file has changed on disk since.  The catalogs are not
+   replaced yet: store an array of them and their new contents in
+   *RELOADEDP, to be freed by the caller, and return its length.  */
+int
+internal_function
+_nl_reload_domains (const char *domainname,
+		    struct reloaded_domain **reloadedp)
+{
+  size_t domainname_len = strlen (domainname);
+  struct loaded_l10nfile *runp;
+  struct reloaded_domain *reloaded;
+  int n;
+  int count;
+  int i;
+
+  /* Collect the catalogs first, so that the list of catalogs is not
+     locked while the files are read.  The entries of the list are never
+     freed.  */
+  gl_rwlock_rdlock (lock);
+
+  n = 0;
+  for (runp = _nl_loaded_domains; runp != NULL; runp = runp->next)
+    if (runp->filename != NULL && runp->decided > 0
+	&& is_catalog_of (runp->filename, domainname, domainname_len))
+      n++;
+
+  reloaded = NULL;
+  if (n > 0)
+    {
+      reloaded =
+	(struct reloaded_domain *) malloc (n * sizeof (struct reloaded_domain));
+      if (reloaded != NULL)
+	{
+	  /* The 'decided' fields are set under another lock, so that more
+	     catalogs may match by now.  */
+	  i = 0;
+	  for (runp = _nl_loaded_domains; runp != NULL && i < n;
+	       runp = runp->next)
+	    if (runp->filename != NULL && runp->decided > 0
+		&& is_catalog_of (runp->filename, domainname, domainname_len))
+	      reloaded[i++].domain_file = runp;
+	  n = i;
+	}
+    }
+
+  gl_rwlock_unlock (lock);
+
+  if (reloaded == NULL)
+    return 0;
+
+  count = 0;
+  for (i = 0; i < n; i++)
+    {
+      const void *data = _nl_reload_domain (reloaded[i].domain_file);
+
+      if (data != NULL)
+	{
+	  reloaded[count].domain_file = reloaded[i].domain_file;
+	  reloaded[count].data = data;
+	  count++;
+	}
+    }
+
+  if (count == 0)
+    {
+      free (reloaded);
+      return 0;
+    }
+  *reloadedp = reloaded;
+  return count;
+}
+
+
 #ifdef _LIBC
 /* This is called from iconv/gconv_db.c's free_mem, as locales must
    be freed before freeing gconv steps arrays.  */
@@ -206,5 +558,12 @@ _nl_finddomain_subfreeres (void)
       free ((char *) here->filename);
       free (here);
     }
+
+  while (catalog_lists != NULL)
+    {
+      struct catalog_list *here = catalog_lists;
+      catalog_lists = catalog_lists->next;
+      free_catalog_list (here);
+    }
 }
 #endif
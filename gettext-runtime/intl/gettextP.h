@@ -19,6 +19,7 @@
 #define _GETTEXTP_H
 
 #include <stddef.h>		/* Get size_t.  */
+#include <sys/types.h>		/* Get dev_t, ino_t, off_t, time_t.  */
 
 #ifdef _LIBC
 # include "../iconv/gconv_int.h"
@@ -59,6 +60,22 @@ extern char *__bindtextdomain (const char *__domainname,
 			       const char *__dirname);
 extern char *__bind_textdomain_codeset (const char *__domainname,
 					const char *__codeset);
+extern int __textdomain_preload (const char *__domainname, int __category);
+extern int __textdomain_reload (const char *__domainname);
+struct textdomain_cache_info;
+extern unsigned long int __textdomain_cache_limit (unsigned long int __limit);
+extern void __textdomain_cache_stats (struct textdomain_cache_info *__stats);
+struct textdomain_context;
+extern struct textdomain_context *
+       __textdomain_context_new (const char *__domainname, int __category,
+				 const char *__localename);
+extern void __textdomain_context_free (struct textdomain_context *__ctx);
+extern char *__textdomain_context_gettext (struct textdomain_context *__ctx,
+					   const char *__msgid);
+extern char *__textdomain_context_ngettext (struct textdomain_context *__ctx,
+					    const char *__msgid1,
+					    const char *__msgid2,
+					    unsigned long int __n);
 extern void _nl_finddomain_subfreeres (void) attribute_hidden;
 extern void _nl_unload_domain (struct loaded_domain *__domain)
      internal_function attribute_hidden;
@@ -159,14 +176,27 @@ struct loaded_domain
 {
   /* Pointer to memory containing the .mo file.  */
   const char *data;
-  /* 1 if the memory is mmap()ed, 0 if the memory is malloc()ed.  */
+  /* 1 if the memory is mmap()ed, 0 if the memory is malloc()ed, 2 if it
+     is part of an mmap()ed bundle.  */
   int use_mmap;
-  /* Size of mmap()ed memory.  */
+  /* Size of the .mo file in memory.  */
   size_t mmap_size;
-  /* 1 if the .mo file uses a different endianness than this machine.  */
+  /* 1 if the tables used by lookups have a different endianness than this
+     machine.  */
   int must_swap;
   /* Pointer to additional malloc()ed memory.  */
   void *malloced;
+  /* Pointer to malloc()ed copies of the tables used by lookups, in the
+     endianness of this machine, or NULL.  */
+  void *native_tabs;
+
+  /* Identity, modification time and size of the .mo file, or of the
+     bundle that contains it, used to detect that the file has been
+     replaced since it was loaded.  */
+  dev_t file_dev;
+  ino_t file_ino;
+  time_t file_mtime;
+  off_t file_size;
 
   /* Number of static strings pairs.  */
   nls_uint32 nstrings;
@@ -189,6 +219,25 @@ struct loaded_domain
   /* 1 if the hash table uses a different endianness than this machine.  */
   int must_swap_hash_tab;
 
+  /* Number of buckets of the perfect hash table.  */
+  nls_uint32 phash_n_buckets;
+  /* Pointer to the displacements of the buckets, or NULL if there is no
+     perfect hash table.  */
+  const nls_uint32 *phash_displ;
+  /* Pointer to the string indices of the slots of the perfect hash
+     table.  */
+  const nls_uint32 *phash_tab;
+
+  /* Number of compressed blocks of translated strings.  */
+  nls_uint32 n_blocks;
+  /* Pointer to descriptors of compressed blocks in the file, or NULL if
+     the translated strings are stored uncompressed.  */
+  const struct compressed_block *blocks;
+  /* For each compressed block, its malloc()ed uncompressed contents, or
+     NULL if it has not been needed so far.  */
+  char **block_data;
+  gl_rwlock_define (, blocks_lock)
+
   /* Cache of charset conversions of the translated strings.  */
   struct converted_domain *conversions;
   size_t nconversions;
@@ -263,6 +312,25 @@ struct loaded_l10nfile *_nl_find_domain (const char *__dirname, char *__locale,
 void _nl_load_domain (struct loaded_l10nfile *__domain,
 		      struct binding *__domainbinding)
      internal_function;
+void _nl_prefault_domain (struct loaded_l10nfile *__domain)
+     internal_function;
+void _nl_skip_domain (struct loaded_l10nfile *__domain)
+     internal_function;
+void _nl_forget_catalog_lists (void)
+     internal_function;
+const void *_nl_reload_domain (struct loaded_l10nfile *__domain)
+     internal_function;
+
+/* A message catalog whose file has changed, and its new contents.  */
+struct reloaded_domain
+{
+  struct loaded_l10nfile *domain_file;
+  const void *data;
+};
+
+int _nl_reload_domains (const char *__domainname,
+			struct reloaded_domain **__reloadedp)
+     internal_function;
 
 #ifdef IN_LIBGLOCALE
 char *_nl_find_msg (struct loaded_l10nfile *domain_file,
@@ -28,6 +28,7 @@
 /* Revision number of the currently used .mo (binary) file format.  */
 #define MO_REVISION_NUMBER 0
 #define MO_REVISION_NUMBER_WITH_SYSDEP_I 1
+#define MO_REVISION_NUMBER_COMPRESSED 2
 
 /* The following contortions are an attempt to use the C preprocessor
    to determine an unsigned integral type that is 32 bits wide.  An
@@ -75,7 +76,8 @@ struct mo_file_header
   /* The revision number of the file format.  */
   nls_uint32 revision;
 
-  /* The following are only used in .mo files with major revision 0 or 1.  */
+  /* The following are only used in .mo files with major revision 0, 1
+     or 2.  */
 
   /* The number of strings pairs.  */
   nls_uint32 nstrings;
@@ -100,8 +102,29 @@ struct mo_file_header
   nls_uint32 orig_sysdep_tab_offset;
   /* Offset of table with start offsets of translated sysdep strings.  */
   nls_uint32 trans_sysdep_tab_offset;
+
+  /* The following are only used in .mo files with minor revision >= 2.  */
+
+  /* The number of buckets of the perfect hash table, or 0 if there is
+     none.  */
+  nls_uint32 phash_n_buckets;
+  /* Offset of table with the displacement of each bucket.  */
+  nls_uint32 phash_displ_offset;
+  /* Offset of table with the index of the original string in each slot.
+     It has nstrings entries.  */
+  nls_uint32 phash_tab_offset;
 };
 
+/* In the perfect hash table, an original string S belongs to the bucket
+     __hash_string_fnv (S) % phash_n_buckets
+   and lies in the slot
+     __hash_string_slot (__hash_string (S), __hash_string_fnv (S), D)
+     % nstrings
+   where D is the displacement of its bucket.  No two original strings lie
+   in the same slot.  The perfect hash table is only present when there are
+   no system dependent strings.  Readers that don't know it use the hash
+   table instead.  */
+
 /* Descriptor for static string contained in the binary .mo file.  */
 struct string_desc
 {
@@ -145,6 +168,74 @@ struct sysdep_string
    regardless whether 'int' is 16 bit, 32 bit, or 64 bit.  */
 #define SEGMENTS_END ((nls_uint32) ~0)
 
+/* The following are only used in .mo files with major revision 2.  */
+
+/* In these files, the header is always complete, and is followed by a
+   struct mo_file_compression.  The static translated strings are stored
+   in compressed blocks, see "lz-block.h".  The offsets in the table of
+   translated strings refer to the concatenation of the uncompressed
+   contents of the blocks, in which a string never crosses a block
+   boundary.  Everything else is stored uncompressed.  */
+
+/* Description of the compressed blocks.  */
+struct mo_file_compression
+{
+  /* The number of compressed blocks.  */
+  nls_uint32 n_blocks;
+  /* Offset of table of struct compressed_block, sorted by start.  */
+  nls_uint32 blocks_offset;
+};
+
+/* Descriptor for a compressed block.  */
+struct compressed_block
+{
+  /* Length of compressed block in file.  */
+  nls_uint32 length;
+  /* Offset of compressed block in file.  */
+  nls_uint32 offset;
+  /* Offset of the uncompressed contents in the concatenation.  */
+  nls_uint32 start;
+  /* Size of the uncompressed contents.  */
+  nls_uint32 size;
+};
+
+/* The magic number of a bundle of GNU message catalogs.  */
+#define _MAGIC_BUNDLE 0x950412df
+#define _MAGIC_BUNDLE_SWAPPED 0xdf120495
+
+/* Revision number of the currently used bundle file format.  */
+#define BUNDLE_REVISION_NUMBER 0
+
+/* A bundle contains several .mo files.  Each of them is stored under the
+   file name it would have relative to a locale directory, such as
+   "de/LC_MESSAGES/hello.mo".  When a directory passed to bindtextdomain
+   is in fact a bundle, the catalogs are taken from the bundle.  */
+
+/* Header for bundle file format.  */
+struct bundle_file_header
+{
+  /* The magic number.  */
+  nls_uint32 magic;
+  /* The revision number of the file format.  */
+  nls_uint32 revision;
+  /* The number of member catalogs.  */
+  nls_uint32 nmembers;
+  /* Offset of table of struct bundle_member, sorted by name.  */
+  nls_uint32 members_offset;
+};
+
+/* Descriptor for a .mo file contained in a bundle.  */
+struct bundle_member
+{
+  /* Offset of NUL terminated name of the member in bundle.  */
+  nls_uint32 name_offset;
+  /* Length of the .mo file.  */
+  nls_uint32 length;
+  /* Offset of the .mo file in bundle, a multiple of 8.  The offsets
+     inside the .mo file are relative to its start.  */
+  nls_uint32 offset;
+};
+
 /* @@ begin of epilog @@ */
 
 #endif	/* gettext.h  */
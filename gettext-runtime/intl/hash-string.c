@@ -48,3 +48,46 @@ __hash_string (const char *str_param)
     }
   return hval;
 }
+
+
+/* Defines the 32-bit FNV-1a function by G. Fowler, L. C. Noll and K.-P. Vo.
+   [see http://www.isthe.com/chongo/tech/comp/fnv/]  */
+unsigned long int
+__hash_string_fnv (const char *str_param)
+{
+  unsigned long int hval;
+  const char *str = str_param;
+
+  hval = 2166136261UL;
+  while (*str != '\0')
+    {
+      hval ^= (unsigned char) *str++;
+      hval = (hval * 16777619UL) & 0xffffffffUL;
+    }
+  return hval;
+}
+
+
+/* The finalizer of A. Appleby's MurmurHash3.  It maps 32-bit values to
+   32-bit values bijectively, with good avalanche.  */
+static unsigned long int
+mix (unsigned long int x)
+{
+  x ^= x >> 16;
+  x = (x * 0x85ebca6bUL) & 0xffffffffUL;
+  x ^= x >> 13;
+  x = (x * 0xc2b2ae35UL) & 0xffffffffUL;
+  x ^= x >> 16;
+  return x;
+}
+
+/* Combines the two hash values HVAL1, HVAL2 of a string with the
+   displacement DISPL, so that each displacement yields an unrelated slot.
+   Strings that agree in one of the two hash values still get different
+   slots.  */
+unsigned long int
+__hash_string_slot (unsigned long int hval1, unsigned long int hval2,
+		    unsigned long int displ)
+{
+  return mix (hval2 ^ mix ((hval1 + displ * 0x9e3779b9UL) & 0xffffffffUL));
+}
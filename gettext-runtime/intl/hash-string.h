@@ -23,8 +23,12 @@
 #ifndef _LIBC
 # ifdef IN_LIBINTL
 #  define __hash_string libintl_hash_string
+#  define __hash_string_fnv libintl_hash_string_fnv
+#  define __hash_string_slot libintl_hash_string_slot
 # else
 #  define __hash_string hash_string
+#  define __hash_string_fnv hash_string_fnv
+#  define __hash_string_slot hash_string_slot
 # endif
 #endif
 
@@ -32,3 +36,15 @@
    [see Aho/Sethi/Ullman, COMPILERS: Principles, Techniques and Tools,
    1986, 1987 Bell Telephone Laboratories, Inc.]  */
 extern unsigned long int __hash_string (const char *str_param);
+
+/* Defines the 32-bit FNV-1a function by G. Fowler, L. C. Noll and K.-P. Vo.
+   It is independent of `hashpjw'.  */
+extern unsigned long int __hash_string_fnv (const char *str_param);
+
+/* Returns the slot, before reduction modulo the table size, of a string
+   with `hashpjw' hash value HVAL1 and `FNV-1a' hash value HVAL2 in the
+   perfect hash table of a .mo file, given the displacement DISPL of its
+   bucket.  The result is < 2^32.  */
+extern unsigned long int __hash_string_slot (unsigned long int hval1,
+					     unsigned long int hval2,
+					     unsigned long int displ);
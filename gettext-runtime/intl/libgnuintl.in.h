@@ -300,6 +300,188 @@ extern char *bind_textdomain_codeset (const char *__domainname,
        _INTL_ASM (libintl_bind_textdomain_codeset);
 #endif
 
+/* Load the DOMAINNAME message catalogs for the current CATEGORY locale
+   ahead of time, so that the first lookups in them don't have to.
+   If DOMAINNAME is null, the current default message catalog is used.
+   Returns the number of message catalogs found.  This function can be
+   called from a worker thread while other threads look up messages.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern int libintl_textdomain_preload (const char *__domainname,
+                                       int __category);
+static inline int textdomain_preload (const char *__domainname,
+                                      int __category)
+{
+  return libintl_textdomain_preload (__domainname, __category);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_preload libintl_textdomain_preload
+#endif
+extern int textdomain_preload (const char *__domainname, int __category)
+       _INTL_ASM (libintl_textdomain_preload);
+#endif
+
+/* Load anew those DOMAINNAME message catalogs whose files have been
+   modified or replaced since they were loaded, and forget the cached
+   translations of DOMAINNAME, but of no other domain.  Strings returned
+   earlier remain valid.  If DOMAINNAME is null, the current default
+   message catalog is used.  Returns the number of catalogs replaced.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern int libintl_textdomain_reload (const char *__domainname);
+static inline int textdomain_reload (const char *__domainname)
+{
+  return libintl_textdomain_reload (__domainname);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_reload libintl_textdomain_reload
+#endif
+extern int textdomain_reload (const char *__domainname)
+       _INTL_ASM (libintl_textdomain_reload);
+#endif
+
+/* Statistics about the cache of translations that were already looked up.  */
+struct textdomain_cache_info
+{
+  unsigned long int entries;	/* Number of cached translations.  */
+  unsigned long int limit;	/* Maximum number, or 0 for no limit.  */
+  unsigned long int hits;	/* Lookups answered from the cache.  */
+  unsigned long int misses;	/* Lookups that had to search catalogs.  */
+  unsigned long int evictions;	/* Entries removed to respect the limit.  */
+};
+
+/* Limit the number of cached translations to LIMIT, evicting the least
+   recently used ones when it is exceeded.  A LIMIT of 0 means no limit,
+   which is the default.  Returns the previous limit.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern unsigned long int
+       libintl_textdomain_cache_limit (unsigned long int __limit);
+static inline unsigned long int
+textdomain_cache_limit (unsigned long int __limit)
+{
+  return libintl_textdomain_cache_limit (__limit);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_cache_limit libintl_textdomain_cache_limit
+#endif
+extern unsigned long int textdomain_cache_limit (unsigned long int __limit)
+       _INTL_ASM (libintl_textdomain_cache_limit);
+#endif
+
+/* Store the statistics about the cache of translations in *STATS.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern void
+       libintl_textdomain_cache_stats (struct textdomain_cache_info *__stats);
+static inline void
+textdomain_cache_stats (struct textdomain_cache_info *__stats)
+{
+  libintl_textdomain_cache_stats (__stats);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_cache_stats libintl_textdomain_cache_stats
+#endif
+extern void textdomain_cache_stats (struct textdomain_cache_info *__stats)
+       _INTL_ASM (libintl_textdomain_cache_stats);
+#endif
+
+/* A translation context holds the message catalogs of a domain for a list
+   of languages, so that lookups through it skip the determination of the
+   locale.  A context must not be used by several threads at once.  */
+struct textdomain_context;
+
+/* Create a translation context for DOMAINNAME and the colon separated list
+   of languages LOCALENAME, or the current locale of CATEGORY if LOCALENAME
+   is null.  If DOMAINNAME is null, the current default message catalog is
+   used.  Returns NULL if out of memory.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern struct textdomain_context *
+       libintl_textdomain_context_new (const char *__domainname,
+                                       int __category,
+                                       const char *__localename);
+static inline struct textdomain_context *
+textdomain_context_new (const char *__domainname, int __category,
+                        const char *__localename)
+{
+  return libintl_textdomain_context_new (__domainname, __category,
+                                         __localename);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_context_new libintl_textdomain_context_new
+#endif
+extern struct textdomain_context *
+       textdomain_context_new (const char *__domainname, int __category,
+                               const char *__localename)
+       _INTL_ASM (libintl_textdomain_context_new);
+#endif
+
+/* Free a translation context.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern void libintl_textdomain_context_free (struct textdomain_context *__ctx);
+static inline void textdomain_context_free (struct textdomain_context *__ctx)
+{
+  libintl_textdomain_context_free (__ctx);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_context_free libintl_textdomain_context_free
+#endif
+extern void textdomain_context_free (struct textdomain_context *__ctx)
+       _INTL_ASM (libintl_textdomain_context_free);
+#endif
+
+/* Look up MSGID in the message catalogs of the translation context CTX.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern char *
+       libintl_textdomain_context_gettext (struct textdomain_context *__ctx,
+                                           const char *__msgid)
+       _INTL_MAY_RETURN_STRING_ARG (2);
+static inline char *
+textdomain_context_gettext (struct textdomain_context *__ctx,
+                            const char *__msgid)
+{
+  return libintl_textdomain_context_gettext (__ctx, __msgid);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_context_gettext libintl_textdomain_context_gettext
+#endif
+extern char *textdomain_context_gettext (struct textdomain_context *__ctx,
+                                         const char *__msgid)
+       _INTL_ASM (libintl_textdomain_context_gettext)
+       _INTL_MAY_RETURN_STRING_ARG (2);
+#endif
+
+/* Similar to `textdomain_context_gettext' but select the plural form
+   corresponding to the number N.  */
+#ifdef _INTL_REDIRECT_INLINE
+extern char *
+       libintl_textdomain_context_ngettext (struct textdomain_context *__ctx,
+                                            const char *__msgid1,
+                                            const char *__msgid2,
+                                            unsigned long int __n)
+       _INTL_MAY_RETURN_STRING_ARG (2) _INTL_MAY_RETURN_STRING_ARG (3);
+static inline char *
+textdomain_context_ngettext (struct textdomain_context *__ctx,
+                             const char *__msgid1, const char *__msgid2,
+                             unsigned long int __n)
+{
+  return libintl_textdomain_context_ngettext (__ctx, __msgid1, __msgid2, __n);
+}
+#else
+#ifdef _INTL_REDIRECT_MACROS
+# define textdomain_context_ngettext libintl_textdomain_context_ngettext
+#endif
+extern char *textdomain_context_ngettext (struct textdomain_context *__ctx,
+                                          const char *__msgid1,
+                                          const char *__msgid2,
+                                          unsigned long int __n)
+       _INTL_ASM (libintl_textdomain_context_ngettext)
+       _INTL_MAY_RETURN_STRING_ARG (2) _INTL_MAY_RETURN_STRING_ARG (3);
+#endif
+
 #endif /* IN_LIBGLOCALE */
 
 
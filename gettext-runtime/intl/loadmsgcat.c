@@ -29,6 +29,7 @@
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stddef.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -86,6 +87,7 @@ char *alloca ();
 #include "gmo.h"
 #include "gettextP.h"
 #include "hash-string.h"
+#include "lz-block.h"
 #include "plural-exp.h"
 
 #ifdef _LIBC
@@ -100,6 +102,11 @@ char *alloca ();
 # include "lock.h"
 #endif
 
+/* Some compilers, like SunOS4 cc, don't have offsetof in <stddef.h>.  */
+#ifndef offsetof
+# define offsetof(type,ident) ((size_t)&(((type*)0)->ident))
+#endif
+
 #ifdef _LIBC
 # define PRI_MACROS_BROKEN 0
 #endif
@@ -778,6 +785,273 @@ get_sysdep_segment_value (const char *name)
   return NULL;
 }
 
+#ifdef HAVE_MMAP
+/* A bundle of message catalogs, mapped into memory.  */
+struct loaded_bundle
+{
+  struct loaded_bundle *next;
+  /* Pointer to the mmap()ed bundle.  */
+  const char *data;
+  size_t size;
+  int must_swap;
+  nls_uint32 nmembers;
+  const struct bundle_member *members;
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+  char filename[ZERO];
+};
+
+/* Lock that protects the 'decided' and 'data' fields of the catalogs
+   while they are loaded, and the list of bundles.  */
+__libc_lock_define_initialized_recursive (static, lock)
+
+/* The bundles opened so far, the most recently mapped first.  Bundles stay
+   mapped until the program exits, because the catalogs taken from them
+   point into them.  When the file of a bundle is replaced, the new file is
+   mapped in addition to the old one.  Files that are not valid bundles are
+   not recorded, so that a bundle installed later is found.  Accesses are
+   protected by 'lock'.  */
+static struct loaded_bundle *loaded_bundles;
+
+/* Map the file whose name is the first FILENAME_LEN bytes of FILENAME, and
+   check whether it is a bundle.  Return NULL if it is not a valid bundle or
+   if out of memory.  */
+static struct loaded_bundle *
+load_bundle (const char *filename, size_t filename_len)
+{
+  struct loaded_bundle *bundle;
+  int fd;
+  size_t size;
+  const char *data;
+  const struct bundle_file_header *header;
+  int must_swap;
+  nls_uint32 nmembers;
+  nls_uint32 members_offset;
+  nls_uint32 i;
+
+  bundle = (struct loaded_bundle *)
+    malloc (sizeof (struct loaded_bundle) + filename_len);
+  if (bundle == NULL)
+    return NULL;
+  memcpy (bundle->filename, filename, filename_len);
+  bundle->filename[filename_len] = '\0';
+
+  fd = open (bundle->filename, O_RDONLY | O_BINARY);
+  if (fd == -1)
+    goto fail;
+  if (
+#ifdef _LIBC
+      fstat64 (fd, &bundle->st) != 0
+#else
+      fstat (fd, &bundle->st) != 0
+#endif
+      || !S_ISREG (bundle->st.st_mode)
+      || (size = (size_t) bundle->st.st_size) != bundle->st.st_size
+      || size < sizeof (struct bundle_file_header))
+    {
+      close (fd);
+      goto fail;
+    }
+  data = (const char *) mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == (const char *) MAP_FAILED)
+    goto fail;
+
+  /* Check the header and the table of members, so that lookups don't need
+     to.  */
+  header = (const struct bundle_file_header *) data;
+  if (header->magic != _MAGIC_BUNDLE && header->magic != _MAGIC_BUNDLE_SWAPPED)
+    goto invalid;
+  must_swap = header->magic != _MAGIC_BUNDLE;
+  /* We support only the major revision 0.  */
+  if ((W (must_swap, header->revision) >> 16) != 0)
+    goto invalid;
+  nmembers = W (must_swap, header->nmembers);
+  members_offset = W (must_swap, header->members_offset);
+  if (members_offset % 4 != 0
+      || members_offset > size
+      || nmembers > (size - members_offset) / sizeof (struct bundle_member))
+    goto invalid;
+  for (i = 0; i < nmembers; i++)
+    {
+      const struct bundle_member *member =
+	(const struct bundle_member *) (data + members_offset) + i;
+      nls_uint32 name_offset = W (must_swap, member->name_offset);
+      nls_uint32 length = W (must_swap, member->length);
+      nls_uint32 offset = W (must_swap, member->offset);
+      const struct mo_file_header *mo_header;
+
+      if (name_offset >= size
+	  || memchr (data + name_offset, '\0', size - name_offset) == NULL
+	  || offset % 8 != 0
+	  || offset > size
+	  || length > size - offset
+	  || length < offsetof (struct mo_file_header, n_sysdep_segments))
+	goto invalid;
+      mo_header = (const struct mo_file_header *) (data + offset);
+      if (mo_header->magic != _MAGIC && mo_header->magic != _MAGIC_SWAPPED)
+	goto invalid;
+    }
+
+  bundle->data = data;
+  bundle->size = size;
+  bundle->must_swap = must_swap;
+  bundle->nmembers = nmembers;
+  bundle->members = (const struct bundle_member *) (data + members_offset);
+  bundle->next = loaded_bundles;
+  loaded_bundles = bundle;
+  return bundle;
+
+ invalid:
+  munmap ((caddr_t) data, size);
+ fail:
+  free (bundle);
+  return NULL;
+}
+
+/* FILENAME has the form DIRNAME/LOCALE/CATEGORY/DOMAIN.mo, where DIRNAME
+   may name a bundle rather than a directory.  Return the length of
+   DIRNAME, or 0 if FILENAME has fewer components.  */
+static size_t
+bundle_dirname_len (const char *filename)
+{
+  const char *p = filename + strlen (filename);
+  int slashes = 0;
+
+  while (slashes < 3)
+    {
+      if (p == filename)
+	return 0;
+      if (*--p == '/')
+	slashes++;
+    }
+  return p - filename;
+}
+
+/* Return the most recently mapped bundle DIRNAME of the catalog FILENAME,
+   or NULL if it has not been mapped yet.  The caller must hold 'lock'.  */
+static struct loaded_bundle *
+lookup_bundle (const char *filename, size_t dirname_len)
+{
+  struct loaded_bundle *bundle;
+
+  for (bundle = loaded_bundles; bundle != NULL; bundle = bundle->next)
+    if (strncmp (bundle->filename, filename, dirname_len) == 0
+	&& bundle->filename[dirname_len] == '\0')
+      break;
+  return bundle;
+}
+
+/* Return the bundle that contains the catalog FILENAME, after mapping it
+   anew if its file has been replaced or modified since it was mapped.
+   Return NULL if there is no valid bundle.  */
+static const struct loaded_bundle *
+refresh_bundle (const char *filename)
+{
+  size_t dirname_len = bundle_dirname_len (filename);
+  struct loaded_bundle *bundle;
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+
+  if (dirname_len == 0)
+    return NULL;
+
+  __libc_lock_lock_recursive (lock);
+  bundle = lookup_bundle (filename, dirname_len);
+  if (bundle == NULL
+      || (
+#ifdef _LIBC
+	  stat64 (bundle->filename, &st) != 0
+#else
+	  stat (bundle->filename, &st) != 0
+#endif
+	  || st.st_dev != bundle->st.st_dev
+	  || st.st_ino != bundle->st.st_ino
+	  || st.st_mtime != bundle->st.st_mtime
+	  || st.st_size != bundle->st.st_size))
+    bundle = load_bundle (filename, dirname_len);
+  __libc_lock_unlock_recursive (lock);
+
+  return bundle;
+}
+
+/* Look for the catalog FILENAME inside a bundle.  FILENAME has the form
+   DIRNAME/LOCALE/CATEGORY/DOMAIN.mo, where DIRNAME may name a bundle
+   rather than a directory.  Return the bundle and store the location of
+   the catalog in *DATAP and *SIZEP, or return NULL.  */
+static const struct loaded_bundle *
+find_in_bundle (const char *filename, const char **datap, size_t *sizep)
+{
+  const char *member_name;
+  size_t dirname_len;
+  struct loaded_bundle *bundle;
+  nls_uint32 lo;
+  nls_uint32 hi;
+
+  dirname_len = bundle_dirname_len (filename);
+  if (dirname_len == 0)
+    return NULL;
+  member_name = filename + dirname_len + 1;
+
+  bundle = lookup_bundle (filename, dirname_len);
+  if (bundle == NULL)
+    {
+      bundle = load_bundle (filename, dirname_len);
+      if (bundle == NULL)
+	return NULL;
+    }
+
+  /* Locate the member by binary search.  */
+  lo = 0;
+  hi = bundle->nmembers;
+  while (lo < hi)
+    {
+      nls_uint32 mid = lo + (hi - lo) / 2;
+      const struct bundle_member *member = &bundle->members[mid];
+      int cmp =
+	strcmp (member_name,
+		bundle->data + W (bundle->must_swap, member->name_offset));
+
+      if (cmp < 0)
+	hi = mid;
+      else if (cmp > 0)
+	lo = mid + 1;
+      else
+	{
+	  *datap = bundle->data + W (bundle->must_swap, member->offset);
+	  *sizep = W (bundle->must_swap, member->length);
+	  return bundle;
+	}
+    }
+  return NULL;
+}
+#endif
+
+/* Return 1 if a table of N elements of ELSIZE bytes at OFFSET lies within
+   a file of SIZE bytes.  */
+static int
+table_fits (nls_uint32 offset, size_t n, size_t elsize, size_t size)
+{
+  return n <= size / elsize && offset <= size - n * elsize;
+}
+
+/* Store the N numbers at SRC, with their bytes swapped, at DST.  The
+   iterations are independent, so that compilers can vectorize the loop.  */
+static void
+swap_table (nls_uint32 *dst, const nls_uint32 *src, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    dst[i] = SWAP (src[i]);
+}
+
 /* Load the message catalogs specified by FILENAME.  If it is no valid
    message catalog do nothing.  */
 void
@@ -798,7 +1072,6 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   int revision;
   const char *nullentry;
   size_t nullentrylen;
-  __libc_lock_define_initialized_recursive (static, lock);
 
   __libc_lock_lock_recursive (lock);
   if (domain_file->decided != 0)
@@ -832,7 +1105,27 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   /* Try to open the addressed file.  */
   fd = open (domain_file->filename, O_RDONLY | O_BINARY);
   if (fd == -1)
-    goto out;
+    {
+#ifdef HAVE_MMAP
+      /* If a directory in the file name is a regular file, it may be a
+	 bundle that contains the catalog.  */
+      if (errno == ENOTDIR)
+	{
+	  const char *member_data;
+	  const struct loaded_bundle *bundle =
+	    find_in_bundle (domain_file->filename, &member_data, &size);
+
+	  if (bundle != NULL)
+	    {
+	      data = (struct mo_file_header *) member_data;
+	      use_mmap = 2;
+	      st = bundle->st;
+	      goto loaded;
+	    }
+	}
+#endif
+      goto out;
+    }
 
   /* We must know about the size of the file.  */
   if (
@@ -842,7 +1135,10 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
       __builtin_expect (fstat (fd, &st) != 0, 0)
 #endif
       || __builtin_expect ((size = (size_t) st.st_size) != st.st_size, 0)
-      || __builtin_expect (size < sizeof (struct mo_file_header), 0))
+      /* The fields for minor revision 0 must be present.  The others are
+	 checked below, depending on the revision.  */
+      || __builtin_expect (size < offsetof (struct mo_file_header,
+					    n_sysdep_segments), 0))
     /* Something went wrong.  */
     goto out;
 
@@ -912,6 +1208,9 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
       goto out;
     }
 
+#ifdef HAVE_MMAP
+ loaded:
+#endif
   domain = (struct loaded_domain *) malloc (sizeof (struct loaded_domain));
   if (domain == NULL)
     goto out;
@@ -922,14 +1221,23 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   domain->mmap_size = size;
   domain->must_swap = data->magic != _MAGIC;
   domain->malloced = NULL;
+  domain->native_tabs = NULL;
+  domain->n_blocks = 0;
+  domain->blocks = NULL;
+  domain->block_data = NULL;
+  domain->file_dev = st.st_dev;
+  domain->file_ino = st.st_ino;
+  domain->file_mtime = st.st_mtime;
+  domain->file_size = st.st_size;
 
   /* Fill in the information about the available tables.  */
   revision = W (domain->must_swap, data->revision);
-  /* We support only the major revisions 0 and 1.  */
+  /* We support only the major revisions 0, 1 and 2.  */
   switch (revision >> 16)
     {
     case 0:
     case 1:
+    case 2:
       domain->nstrings = W (domain->must_swap, data->nstrings);
       domain->orig_tab = (const struct string_desc *)
 	((char *) data + W (domain->must_swap, data->orig_tab_offset));
@@ -942,6 +1250,9 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 	   ((char *) data + W (domain->must_swap, data->hash_tab_offset))
 	 : NULL);
       domain->must_swap_hash_tab = domain->must_swap;
+      domain->phash_n_buckets = 0;
+      domain->phash_displ = NULL;
+      domain->phash_tab = NULL;
 
       /* Now dispatch on the minor revision.  */
       switch (revision & 0xffff)
@@ -959,6 +1270,8 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 	    if (domain->hash_tab == NULL)
 	      /* This is invalid.  These minor revisions need a hash table.  */
 	      goto invalid;
+	    if (size < offsetof (struct mo_file_header, phash_n_buckets))
+	      goto invalid;
 
 	    n_sysdep_strings =
 	      W (domain->must_swap, data->n_sysdep_strings);
@@ -1259,19 +1572,114 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		domain->orig_sysdep_tab = NULL;
 		domain->trans_sysdep_tab = NULL;
 	      }
+
+	    /* Use the perfect hash table only if all strings that the hash
+	       table refers to are static strings.  */
+	    if ((revision & 0xffff) >= 2
+		&& domain->n_sysdep_strings == 0
+		&& size >= sizeof (struct mo_file_header))
+	      {
+		nls_uint32 phash_n_buckets =
+		  W (domain->must_swap, data->phash_n_buckets);
+		nls_uint32 phash_displ_offset =
+		  W (domain->must_swap, data->phash_displ_offset);
+		nls_uint32 phash_tab_offset =
+		  W (domain->must_swap, data->phash_tab_offset);
+
+		/* Lookups through the perfect hash table reduce modulo the
+		   number of strings.  */
+		if (phash_n_buckets > 0
+		    && domain->nstrings > 0
+		    && phash_displ_offset <= size
+		    && (size - phash_displ_offset) / sizeof (nls_uint32)
+		       >= phash_n_buckets
+		    && phash_tab_offset <= size
+		    && (size - phash_tab_offset) / sizeof (nls_uint32)
+		       >= domain->nstrings)
+		  {
+		    domain->phash_n_buckets = phash_n_buckets;
+		    domain->phash_displ = (const nls_uint32 *)
+		      ((char *) data + phash_displ_offset);
+		    domain->phash_tab = (const nls_uint32 *)
+		      ((char *) data + phash_tab_offset);
+		  }
+	      }
 	  }
 	  break;
 	}
+
+      if ((revision >> 16) == MO_REVISION_NUMBER_COMPRESSED)
+	{
+	  /* The translated static strings are stored in compressed blocks.
+	     Check the table of blocks here, so that lookups don't need to.
+	     The blocks are uncompressed when they are first needed.  */
+	  const struct mo_file_compression *compression;
+	  nls_uint32 n_blocks;
+	  nls_uint32 blocks_offset;
+	  nls_uint32 next_start;
+	  nls_uint32 i;
+
+	  if (size < (sizeof (struct mo_file_header)
+		      + sizeof (struct mo_file_compression)))
+	    goto invalid;
+	  compression = (const struct mo_file_compression *)
+	    ((char *) data + sizeof (struct mo_file_header));
+	  n_blocks = W (domain->must_swap, compression->n_blocks);
+	  blocks_offset = W (domain->must_swap, compression->blocks_offset);
+	  if (blocks_offset % 4 != 0
+	      || blocks_offset > size
+	      || (size - blocks_offset) / sizeof (struct compressed_block)
+		 < n_blocks)
+	    goto invalid;
+	  domain->blocks = (const struct compressed_block *)
+	    ((char *) data + blocks_offset);
+
+	  next_start = 0;
+	  for (i = 0; i < n_blocks; i++)
+	    {
+	      const struct compressed_block *block = &domain->blocks[i];
+	      nls_uint32 length = W (domain->must_swap, block->length);
+	      nls_uint32 offset = W (domain->must_swap, block->offset);
+	      nls_uint32 start = W (domain->must_swap, block->start);
+	      nls_uint32 block_size = W (domain->must_swap, block->size);
+
+	      if (offset > size
+		  || length > size - offset
+		  || start < next_start
+		  || block_size == 0
+		  || block_size / LZ_BLOCK_MAX_RATIO > length
+		  || start + block_size < start)
+		goto invalid;
+	      next_start = start + block_size;
+	    }
+
+	  if (n_blocks > 0)
+	    {
+	      domain->block_data = (char **) calloc (n_blocks, sizeof (char *));
+	      if (domain->block_data == NULL)
+		goto invalid;
+	    }
+	  domain->n_blocks = n_blocks;
+	}
       break;
     default:
       /* This is an invalid revision.  */
     invalid:
       /* This is an invalid .mo file or we ran out of resources.  */
+      if (domain->block_data != NULL)
+	{
+	  nls_uint32 i;
+
+	  for (i = 0; i < domain->n_blocks; i++)
+	    free (domain->block_data[i]);
+	  free (domain->block_data);
+	}
+      free (domain->native_tabs);
       free (domain->malloced);
 #ifdef HAVE_MMAP
-      if (use_mmap)
+      if (use_mmap == 1)
 	munmap ((caddr_t) data, size);
-      else
+      else if (use_mmap == 0)
 #endif
 	free (data);
       free (domain);
@@ -1279,13 +1687,78 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
       goto out;
     }
 
+  /* In a .mo file of the other endianness, lookups would have to swap every
+     number that they read.  Instead, swap the tables that they use once.
+     Keep swapping at each lookup if the tables are not within the file or
+     the memory is not available.  */
+  if (domain->must_swap
+      && table_fits (W (domain->must_swap, data->orig_tab_offset),
+		     domain->nstrings, sizeof (struct string_desc), size)
+      && table_fits (W (domain->must_swap, data->trans_tab_offset),
+		     domain->nstrings, sizeof (struct string_desc), size)
+      && (!domain->must_swap_hash_tab || domain->hash_tab == NULL
+	  || table_fits (W (domain->must_swap, data->hash_tab_offset),
+			 domain->hash_size, sizeof (nls_uint32), size)))
+    {
+      size_t n_tab = 2 * domain->nstrings;
+      size_t n_hash =
+	(domain->must_swap_hash_tab && domain->hash_tab != NULL
+	 ? domain->hash_size
+	 : 0);
+      size_t n_displ =
+	(domain->phash_displ != NULL ? domain->phash_n_buckets : 0);
+      size_t n_phash = (domain->phash_displ != NULL ? domain->nstrings : 0);
+      size_t n_blocks = (domain->blocks != NULL ? 4 * domain->n_blocks : 0);
+      nls_uint32 *tabs =
+	(nls_uint32 *)
+	malloc ((2 * n_tab + n_hash + n_displ + n_phash + n_blocks)
+		* sizeof (nls_uint32));
+
+      if (tabs != NULL)
+	{
+	  nls_uint32 *p = tabs;
+
+	  swap_table (p, (const nls_uint32 *) domain->orig_tab, n_tab);
+	  domain->orig_tab = (const struct string_desc *) p;
+	  p += n_tab;
+	  swap_table (p, (const nls_uint32 *) domain->trans_tab, n_tab);
+	  domain->trans_tab = (const struct string_desc *) p;
+	  p += n_tab;
+	  if (n_hash > 0)
+	    {
+	      swap_table (p, domain->hash_tab, n_hash);
+	      domain->hash_tab = p;
+	      domain->must_swap_hash_tab = 0;
+	      p += n_hash;
+	    }
+	  if (domain->phash_displ != NULL)
+	    {
+	      swap_table (p, domain->phash_displ, n_displ);
+	      domain->phash_displ = p;
+	      p += n_displ;
+	      swap_table (p, domain->phash_tab, n_phash);
+	      domain->phash_tab = p;
+	      p += n_phash;
+	    }
+	  if (domain->blocks != NULL)
+	    {
+	      swap_table (p, (const nls_uint32 *) domain->blocks, n_blocks);
+	      domain->blocks = (const struct compressed_block *) p;
+	    }
+	  domain->native_tabs = tabs;
+	  domain->must_swap = 0;
+	}
+    }
+
   /* No caches of converted translations so far.  */
   domain->conversions = NULL;
   domain->nconversions = 0;
 #ifdef _LIBC
   __libc_rwlock_init (domain->conversions_lock);
+  __libc_rwlock_init (domain->blocks_lock);
 #else
   gl_rwlock_init (domain->conversions_lock);
+  gl_rwlock_init (domain->blocks_lock);
 #endif
 
   /* Get the header entry and look for a plural specification.  */
@@ -1299,6 +1772,7 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
     {
 #ifdef _LIBC
       __libc_rwlock_fini (domain->conversions_lock);
+      __libc_rwlock_fini (domain->blocks_lock);
 #endif
       goto invalid;
     }
@@ -1315,6 +1789,117 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 }
 
 
+/* Record that the message catalog DOMAIN_FILE does not exist, as
+   _nl_load_domain does when it cannot open the file, unless it has been
+   looked at already.  */
+void
+internal_function
+_nl_skip_domain (struct loaded_l10nfile *domain_file)
+{
+  __libc_lock_lock_recursive (lock);
+  if (domain_file->decided == 0)
+    {
+      domain_file->data = NULL;
+      domain_file->decided = 1;
+    }
+  __libc_lock_unlock_recursive (lock);
+}
+
+
+/* Load the message catalog DOMAIN_FILE anew if its file, or the bundle
+   that contains it, has been replaced or modified since it was loaded.
+   Return the new catalog, or NULL if DOMAIN_FILE is up to date or the new
+   file is not a valid message catalog.  DOMAIN_FILE itself is left alone;
+   the caller installs the new catalog.  The old catalog is never freed,
+   because strings returned from it may still be in use.  */
+const void *
+internal_function
+_nl_reload_domain (struct loaded_l10nfile *domain_file)
+{
+#ifdef _LIBC
+  struct stat64 st;
+#else
+  struct stat st;
+#endif
+  const struct loaded_domain *old_domain;
+  struct loaded_l10nfile new_file;
+
+  /* A catalog that was never looked at will be loaded fresh anyway.  */
+  if (domain_file->filename == NULL || domain_file->decided <= 0)
+    return NULL;
+
+  if (
+#ifdef _LIBC
+      stat64 (domain_file->filename, &st) != 0
+#else
+      stat (domain_file->filename, &st) != 0
+#endif
+     )
+    {
+#ifdef HAVE_MMAP
+      /* A catalog in a bundle is replaced together with the bundle.  */
+      const struct loaded_bundle *bundle;
+
+      if (errno == ENOTDIR
+	  && (bundle = refresh_bundle (domain_file->filename)) != NULL)
+	st = bundle->st;
+      else
+#endif
+	/* If the file has disappeared, keep using what we have.  */
+	return NULL;
+    }
+
+  old_domain = (const struct loaded_domain *) domain_file->data;
+  if (old_domain != NULL
+      && old_domain->file_dev == st.st_dev
+      && old_domain->file_ino == st.st_ino
+      && old_domain->file_mtime == st.st_mtime
+      && old_domain->file_size == st.st_size)
+    return NULL;
+
+  /* Load the new contents on the side, so that the old catalog is kept
+     if the new file is not valid.  */
+  new_file.filename = domain_file->filename;
+  new_file.decided = 0;
+  new_file.data = NULL;
+  new_file.next = NULL;
+  new_file.successor[0] = NULL;
+  _nl_load_domain (&new_file, NULL);
+
+  return new_file.data;
+}
+
+
+/* Touch every page of the loaded message catalog DOMAIN_FILE, so that
+   the first lookups in it don't stall on page faults.  */
+void
+internal_function
+_nl_prefault_domain (struct loaded_l10nfile *domain_file)
+{
+#ifdef HAVE_MMAP
+  const struct loaded_domain *domain =
+    (const struct loaded_domain *) domain_file->data;
+
+  if (domain != NULL && domain->use_mmap)
+    {
+      const char *p = domain->data;
+      const char *end = domain->data + domain->mmap_size;
+      size_t pagesize;
+
+# if defined _SC_PAGESIZE
+      long int result = sysconf (_SC_PAGESIZE);
+      pagesize = (result > 0 ? (size_t) result : 4096);
+# else
+      pagesize = 4096;
+# endif
+
+      for (; p < end; p += pagesize)
+	(void) *(volatile const char *) p;
+    }
+#endif
+}
+
+
 #ifdef _LIBC
 void
 internal_function __libc_freeres_fn_section
@@ -1338,12 +1923,21 @@ _nl_unload_domain (struct loaded_domain *domain)
   free (domain->conversions);
   __libc_rwlock_fini (domain->conversions_lock);
 
+  if (domain->block_data != NULL)
+    {
+      for (i = 0; i < domain->n_blocks; i++)
+	free (domain->block_data[i]);
+      free (domain->block_data);
+    }
+  __libc_rwlock_fini (domain->blocks_lock);
+
+  free (domain->native_tabs);
   free (domain->malloced);
 
 # ifdef _POSIX_MAPPED_FILES
-  if (domain->use_mmap)
+  if (domain->use_mmap == 1)
     munmap ((caddr_t) domain->data, domain->mmap_size);
-  else
+  else if (domain->use_mmap == 0)
 # endif	/* _POSIX_MAPPED_FILES */
     free ((void *) domain->data);
 
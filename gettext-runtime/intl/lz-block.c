@@ -0,0 +1,111 @@
+/* Decoding of compressed blocks in message catalogs.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 2.1 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "lz-block.h"
+
+#include <string.h>
+
+
+/* Reads the extension bytes of a literal or match length, starting at
+   *SRCP, and adds them to *LENP.  Returns 0 if ok, or -1 if the extension
+   bytes run past SRC_END or the length overflows.  */
+static int
+read_length (const unsigned char **srcp, const unsigned char *src_end,
+	     size_t *lenp)
+{
+  const unsigned char *src = *srcp;
+  size_t len = *lenp;
+  unsigned char byte;
+
+  do
+    {
+      if (src == src_end)
+	return -1;
+      byte = *src++;
+      if (len + byte < len)
+	return -1;
+      len += byte;
+    }
+  while (byte == 255);
+
+  *srcp = src;
+  *lenp = len;
+  return 0;
+}
+
+int
+__lz_block_decode (const char *src_param, size_t srclen,
+		   char *dst_param, size_t dstlen)
+{
+  const unsigned char *src = (const unsigned char *) src_param;
+  const unsigned char *src_end = src + srclen;
+  unsigned char *dst = (unsigned char *) dst_param;
+  unsigned char *dst_start = dst;
+  unsigned char *dst_end = dst + dstlen;
+
+  for (;;)
+    {
+      unsigned int token;
+      size_t len;
+      size_t distance;
+
+      if (src == src_end)
+	return -1;
+      token = *src++;
+
+      /* Copy the literal bytes.  */
+      len = token >> 4;
+      if (len == 15 && read_length (&src, src_end, &len) < 0)
+	return -1;
+      if (len > (size_t) (src_end - src) || len > (size_t) (dst_end - dst))
+	return -1;
+      memcpy (dst, src, len);
+      src += len;
+      dst += len;
+
+      if (dst == dst_end)
+	/* The output is complete.  The input must be complete too.  */
+	return (src == src_end ? 0 : -1);
+
+      /* Copy the match.  */
+      if (src_end - src < 2)
+	return -1;
+      distance = src[0] | ((size_t) src[1] << 8);
+      src += 2;
+      if (distance == 0 || distance > (size_t) (dst - dst_start))
+	return -1;
+      len = token & 0x0f;
+      if (len == 15 && read_length (&src, src_end, &len) < 0)
+	return -1;
+      if ((size_t) (dst_end - dst) < LZ_BLOCK_MIN_MATCH
+	  || len > (size_t) (dst_end - dst) - LZ_BLOCK_MIN_MATCH)
+	return -1;
+      len += LZ_BLOCK_MIN_MATCH;
+      /* The source and the destination of the copy may overlap.  */
+      {
+	const unsigned char *from = dst - distance;
+	const unsigned char *from_end = from + len;
+
+	while (from < from_end)
+	  *dst++ = *from++;
+      }
+    }
+}
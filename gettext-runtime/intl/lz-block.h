@@ -0,0 +1,61 @@
+/* Description of GNU message catalog format: compressed blocks.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 2.1 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stddef.h>
+
+/* @@ end of prolog @@ */
+
+/* A compressed block, in the style of LZ4, is a sequence of commands.
+   Each command consists of
+     - a token byte.  Its upper 4 bits L and its lower 4 bits M give the
+       number of literal bytes and the length of the match, minus
+       LZ_BLOCK_MIN_MATCH.  When L or M is 15, the value is continued by
+       extension bytes that are added to it, up to and including the first
+       extension byte that is not 255.
+     - the extension bytes of L, if any.
+     - L literal bytes, that are copied to the output.
+     - unless the output is complete after the literal bytes, the distance
+       D >= 1 of the match, as 2 bytes in little-endian order, followed by
+       the extension bytes of M, if any.  M + LZ_BLOCK_MIN_MATCH bytes are
+       copied, one by one, from D bytes before the current output position.
+   The last command of a block has no match.  */
+
+/* The minimal length of a match.  */
+#define LZ_BLOCK_MIN_MATCH 4
+
+/* The maximal distance of a match.  */
+#define LZ_BLOCK_MAX_DISTANCE 65535
+
+/* A block of N bytes decodes to less than N * LZ_BLOCK_MAX_RATIO bytes:
+   every byte of a command, except the extension bytes of M, produces at
+   most LZ_BLOCK_MIN_MATCH + 15 bytes of output, and an extension byte at
+   most 255.  */
+#define LZ_BLOCK_MAX_RATIO 255
+
+
+#ifndef _LIBC
+# ifdef IN_LIBINTL
+#  define __lz_block_decode libintl_lz_block_decode
+# else
+#  define __lz_block_decode lz_block_decode
+# endif
+#endif
+
+/* Decodes the compressed block of SRCLEN bytes at SRC into the DSTLEN bytes
+   at DST.  Returns 0 if the block is valid and decodes to exactly DSTLEN
+   bytes, or -1 otherwise.  */
+extern int __lz_block_decode (const char *src, size_t srclen,
+			      char *dst, size_t dstlen);
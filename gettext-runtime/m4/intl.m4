@@ -199,6 +199,7 @@ dnl   finddomain.c
 dnl   gettextP.h
 dnl   gmo.h
 dnl   hash-string.h hash-string.c
+dnl   lz-block.h lz-block.c
 dnl   l10nflist.c
 dnl   libgnuintl.h.in (except the *printf stuff)
 dnl   loadinfo.h
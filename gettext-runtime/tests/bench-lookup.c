@@ -0,0 +1,678 @@
+/* Benchmark of message lookups in libintl.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published by
+   the Free Software Foundation; either version 2.1 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This program writes a synthetic message catalog, looks up messages in it
+   and prints the time that the lookups take.  It measures:
+     - the time to load a catalog, at the first lookup in its domain,
+     - the time of a gettext, ngettext, pgettext or pgettext_expr lookup of
+       a message that is in the catalog, and of a gettext lookup of a
+       message that is not,
+     - the throughput of gettext lookups in 1, 2, 4, ... threads,
+     - the memory that the loaded catalogs take.
+   The results go to standard output, one per line, as tab separated
+   fields: name of the measurement, number of threads, value, unit.
+   Lines starting with '#' are comments.
+
+   It must be run in a locale other than the "C" locale, since lookups in
+   the "C" locale don't consult any catalog.  It measures the libintl that
+   it is linked with: the one in ../intl if the package was configured with
+   --with-included-gettext, otherwise the one of the system.  */
+
+#include <config.h>
+
+#include <errno.h>
+#include <locale.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if USE_POSIX_THREADS
+# include <pthread.h>
+#endif
+
+#include <libintl.h>
+
+#include "gettext.h"
+#include "gmo.h"
+#include "hash-string.h"
+
+/* Name of the language of the catalogs, set through $LANGUAGE.  */
+#define LANGUAGE_NAME "bench"
+
+/* Name of the domain that the lookups are done in.  */
+#define DOMAIN_NAME "bench-lookup"
+
+/* Options, with their default values.  */
+static unsigned int n_messages = 10000;
+static unsigned int n_plurals = 2;
+static const char *charset = "UTF-8";
+static unsigned int max_threads = 4;
+static unsigned long int iterations = 1000000;
+static unsigned int n_loads = 20;
+static const char *directory = "bench-lookup.d";
+
+/* The keys of the lookups: msgids that are in the catalog, singular msgids
+   of plural messages, msgids with a context (joined with the context, as
+   the pgettext macro does at compile time, and alone), and msgids that are
+   not in the catalog.  */
+static char **hit_keys;
+static unsigned int n_hit_keys;
+static char **plural_keys;
+static char **plural_plural_keys;
+static unsigned int n_plural_keys;
+static char **context_keys;
+static char **context_msgids;
+static unsigned int n_context_keys;
+static char **miss_keys;
+static unsigned int n_miss_keys;
+
+/* The context of the messages with a context.  */
+#define CONTEXT "context"
+
+/* Defeats the optimization of the lookups.  */
+static volatile size_t sink;
+
+
+static void *
+xmalloc (size_t size)
+{
+  void *p = malloc (size);
+
+  if (p == NULL)
+    {
+      fputs ("bench-lookup: out of memory\n", stderr);
+      exit (1);
+    }
+  return p;
+}
+
+static char *
+xstrdup (const char *string)
+{
+  return strcpy ((char *) xmalloc (strlen (string) + 1), string);
+}
+
+static char *
+xasprintf_uint (const char *format, unsigned int n)
+{
+  char *s = (char *) xmalloc (strlen (format) + 3 * sizeof (unsigned int) + 1);
+
+  sprintf (s, format, n);
+  return s;
+}
+
+/* Return the current time, in seconds.  */
+static double
+now (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* Return the resident set size of this process, in KiB, or -1 if it is
+   not known.  */
+static long
+resident_size (void)
+{
+  FILE *fp = fopen ("/proc/self/statm", "r");
+  long size;
+  long resident;
+
+  if (fp == NULL)
+    return -1;
+  if (fscanf (fp, "%ld %ld", &size, &resident) != 2)
+    resident = -1;
+  fclose (fp);
+  if (resident < 0)
+    return -1;
+  return resident * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+static void
+report (const char *name, unsigned int threads, double value,
+        const char *unit)
+{
+  printf ("%s\t%u\t%.1f\t%s\n", name, threads, value, unit);
+  fflush (stdout);
+}
+
+
+/* A message of the synthetic catalog.  */
+struct message
+{
+  char *msgid;
+  char *msgstr;
+  size_t msgstr_len;
+};
+
+static int
+compare_messages (const void *p1, const void *p2)
+{
+  return strcmp (((const struct message *) p1)->msgid,
+                 ((const struct message *) p2)->msgid);
+}
+
+/* Return the smallest prime >= SEED.  */
+static unsigned int
+next_prime (unsigned int seed)
+{
+  unsigned int divisor;
+
+  if (seed < 3)
+    return 3;
+  seed |= 1;
+  for (divisor = 3; divisor * divisor <= seed; )
+    if (seed % divisor == 0)
+      {
+        seed += 2;
+        divisor = 3;
+      }
+    else
+      divisor += 2;
+  return seed;
+}
+
+/* Build the messages of the synthetic catalog, and the keys of the
+   lookups.  Every fourth message has a plural form, and every fourth
+   message has a context.  */
+static struct message *
+make_messages (unsigned int *countp)
+{
+  unsigned int count = n_messages + 1;
+  struct message *messages =
+    (struct message *) xmalloc (count * sizeof (struct message));
+  char header[200];
+  unsigned int i;
+
+  if (n_plurals > 1)
+    sprintf (header,
+             "Content-Type: text/plain; charset=%.80s\n"
+             "Plural-Forms: nplurals=%u; plural=n %% %u;\n",
+             charset, n_plurals, n_plurals);
+  else
+    sprintf (header,
+             "Content-Type: text/plain; charset=%.80s\n"
+             "Plural-Forms: nplurals=1; plural=0;\n",
+             charset);
+  messages[0].msgid = xstrdup ("");
+  messages[0].msgstr = xstrdup (header);
+  messages[0].msgstr_len = strlen (header) + 1;
+
+  hit_keys = (char **) xmalloc (n_messages * sizeof (char *));
+  plural_keys = (char **) xmalloc (n_messages * sizeof (char *));
+  plural_plural_keys = (char **) xmalloc (n_messages * sizeof (char *));
+  context_keys = (char **) xmalloc (n_messages * sizeof (char *));
+  context_msgids = (char **) xmalloc (n_messages * sizeof (char *));
+  miss_keys = (char **) xmalloc (n_messages * sizeof (char *));
+  n_hit_keys = n_plural_keys = n_context_keys = n_miss_keys = 0;
+
+  for (i = 0; i < n_messages; i++)
+    {
+      struct message *mp = &messages[i + 1];
+
+      switch (i % 4)
+        {
+        case 2:
+          {
+            /* A message with plural forms.  */
+            char *forms;
+            size_t length;
+            unsigned int k;
+
+            mp->msgid = xasprintf_uint ("%u file", i);
+            plural_keys[n_plural_keys] = mp->msgid;
+            plural_plural_keys[n_plural_keys] = xasprintf_uint ("%u files", i);
+            n_plural_keys++;
+
+            forms = (char *) xmalloc (n_plurals * 40);
+            length = 0;
+            for (k = 0; k < n_plurals; k++)
+              length += sprintf (forms + length, "form %u of %u Datei", k, i)
+                        + 1;
+            mp->msgstr = forms;
+            mp->msgstr_len = length;
+          }
+          break;
+        case 3:
+          /* A message with a context.  */
+          mp->msgid =
+            xasprintf_uint (CONTEXT GETTEXT_CONTEXT_GLUE "message number %u",
+                            i);
+          mp->msgstr = xasprintf_uint ("Kontext der Nachricht %u", i);
+          mp->msgstr_len = strlen (mp->msgstr) + 1;
+          context_keys[n_context_keys] = mp->msgid;
+          context_msgids[n_context_keys] =
+            mp->msgid + strlen (CONTEXT GETTEXT_CONTEXT_GLUE);
+          n_context_keys++;
+          break;
+        default:
+          mp->msgid = xasprintf_uint ("message number %u", i);
+          mp->msgstr = xasprintf_uint ("Nachricht mit der Nummer %u", i);
+          mp->msgstr_len = strlen (mp->msgstr) + 1;
+          hit_keys[n_hit_keys++] = mp->msgid;
+          break;
+        }
+      miss_keys[n_miss_keys++] = xasprintf_uint ("missing message %u", i);
+    }
+
+  qsort (messages, count, sizeof (struct message), compare_messages);
+  *countp = count;
+  return messages;
+}
+
+/* Write the COUNT sorted MESSAGES to the .mo file FILE_NAME, with a hash
+   table, in the same layout as msgfmt does.  */
+static void
+write_catalog (const char *file_name, const struct message *messages,
+               unsigned int count)
+{
+  struct mo_file_header header;
+  struct string_desc *orig_tab;
+  struct string_desc *trans_tab;
+  nls_uint32 hash_tab_size;
+  nls_uint32 *hash_tab;
+  size_t header_size;
+  nls_uint32 offset;
+  FILE *fp;
+  unsigned int j;
+
+  hash_tab_size = next_prime ((count * 4) / 3);
+  hash_tab = (nls_uint32 *) xmalloc (hash_tab_size * sizeof (nls_uint32));
+  memset (hash_tab, '\0', hash_tab_size * sizeof (nls_uint32));
+  for (j = 0; j < count; j++)
+    {
+      nls_uint32 hash_val = __hash_string (messages[j].msgid);
+      nls_uint32 idx = hash_val % hash_tab_size;
+
+      if (hash_tab[idx] != 0)
+        {
+          nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
+
+          do
+            if (idx >= hash_tab_size - incr)
+              idx -= hash_tab_size - incr;
+            else
+              idx += incr;
+          while (hash_tab[idx] != 0);
+        }
+      hash_tab[idx] = j + 1;
+    }
+
+  header_size = offsetof (struct mo_file_header, n_sysdep_segments);
+  memset (&header, '\0', sizeof (header));
+  header.magic = _MAGIC;
+  header.revision = MO_REVISION_NUMBER;
+  header.nstrings = count;
+  header.orig_tab_offset = header_size;
+  header.trans_tab_offset =
+    header.orig_tab_offset + count * sizeof (struct string_desc);
+  header.hash_tab_size = hash_tab_size;
+  header.hash_tab_offset =
+    header.trans_tab_offset + count * sizeof (struct string_desc);
+
+  orig_tab =
+    (struct string_desc *) xmalloc (count * sizeof (struct string_desc));
+  trans_tab =
+    (struct string_desc *) xmalloc (count * sizeof (struct string_desc));
+  offset = header.hash_tab_offset + hash_tab_size * sizeof (nls_uint32);
+  for (j = 0; j < count; j++)
+    {
+      orig_tab[j].length = strlen (messages[j].msgid);
+      orig_tab[j].offset = offset;
+      offset += orig_tab[j].length + 1;
+    }
+  for (j = 0; j < count; j++)
+    {
+      trans_tab[j].length = messages[j].msgstr_len - 1;
+      trans_tab[j].offset = offset;
+      offset += messages[j].msgstr_len;
+    }
+
+  fp = fopen (file_name, "wb");
+  if (fp == NULL)
+    {
+      fprintf (stderr, "bench-lookup: cannot create %s: %s\n",
+               file_name, strerror (errno));
+      exit (1);
+    }
+  fwrite (&header, header_size, 1, fp);
+  fwrite (orig_tab, sizeof (struct string_desc), count, fp);
+  fwrite (trans_tab, sizeof (struct string_desc), count, fp);
+  fwrite (hash_tab, sizeof (nls_uint32), hash_tab_size, fp);
+  for (j = 0; j < count; j++)
+    fwrite (messages[j].msgid, strlen (messages[j].msgid) + 1, 1, fp);
+  for (j = 0; j < count; j++)
+    fwrite (messages[j].msgstr, messages[j].msgstr_len, 1, fp);
+  if (ferror (fp) || fclose (fp) != 0)
+    {
+      fprintf (stderr, "bench-lookup: error while writing %s\n", file_name);
+      exit (1);
+    }
+
+  free (trans_tab);
+  free (orig_tab);
+  free (hash_tab);
+}
+
+static void
+make_directory (const char *dir_name)
+{
+  if (mkdir (dir_name, 0777) < 0 && errno != EEXIST)
+    {
+      fprintf (stderr, "bench-lookup: cannot create %s: %s\n",
+               dir_name, strerror (errno));
+      exit (1);
+    }
+}
+
+
+/* Verify that all messages of the catalog are found.  */
+static void
+check_catalog (void)
+{
+  unsigned int k;
+  int found = 1;
+
+  for (k = 0; k < n_hit_keys; k++)
+    if (strcmp (gettext (hit_keys[k]), hit_keys[k]) == 0)
+      found = 0;
+  for (k = 0; k < n_plural_keys; k++)
+    if (strcmp (ngettext (plural_keys[k], plural_plural_keys[k], 1),
+                plural_keys[k]) == 0)
+      found = 0;
+  for (k = 0; k < n_context_keys; k++)
+    if (strcmp (pgettext_expr (CONTEXT, context_msgids[k]),
+                context_msgids[k]) == 0)
+      found = 0;
+  if (!found)
+    {
+      fputs ("bench-lookup: a message of the catalog was not found\n",
+             stderr);
+      exit (1);
+    }
+}
+
+/* Measure the loading of a catalog.  Every domain has its own copy of the
+   catalog, so that every first lookup loads a catalog.  */
+static void
+bench_load (const struct message *messages, unsigned int count,
+            const char *messages_dir)
+{
+  char *file_name =
+    (char *) xmalloc (strlen (messages_dir) + sizeof DOMAIN_NAME + 20);
+  char domain[sizeof DOMAIN_NAME + 20];
+  double total;
+  unsigned int r;
+
+  total = 0;
+  for (r = 0; r < n_loads; r++)
+    {
+      double start;
+
+      sprintf (domain, "%s-%u", DOMAIN_NAME, r);
+      sprintf (file_name, "%s/%s.mo", messages_dir, domain);
+      write_catalog (file_name, messages, count);
+      bindtextdomain (domain, directory);
+
+      start = now ();
+      sink += (size_t) dgettext (domain, hit_keys[0]);
+      total += now () - start;
+    }
+  if (n_loads > 0)
+    report ("load", 1, total / n_loads * 1e6, "us");
+
+  free (file_name);
+}
+
+/* Measure the lookup of the N_KEYS KEYS, ITERATIONS times in total.  */
+static void
+bench_gettext (const char *name, char **keys, unsigned int n_keys)
+{
+  double start;
+  unsigned long int i;
+  unsigned int k;
+
+  start = now ();
+  for (i = 0, k = 0; i < iterations; i++)
+    {
+      sink += (size_t) gettext (keys[k]);
+      if (++k == n_keys)
+        k = 0;
+    }
+  report (name, 1, (now () - start) / iterations * 1e9, "ns");
+}
+
+static void
+bench_ngettext (void)
+{
+  double start;
+  unsigned long int i;
+  unsigned int k;
+
+  start = now ();
+  for (i = 0, k = 0; i < iterations; i++)
+    {
+      sink +=
+        (size_t) ngettext (plural_keys[k], plural_plural_keys[k], i % 10);
+      if (++k == n_plural_keys)
+        k = 0;
+    }
+  report ("ngettext-hit", 1, (now () - start) / iterations * 1e9, "ns");
+}
+
+/* Measure pgettext lookups.  For string literals, pgettext (CONTEXT, MSGID)
+   expands to pgettext_aux with the key joined at compile time; for other
+   expressions, pgettext_expr joins the key at run time.  */
+static void
+bench_pgettext (void)
+{
+  double start;
+  unsigned long int i;
+  unsigned int k;
+
+  start = now ();
+  for (i = 0, k = 0; i < iterations; i++)
+    {
+      sink += (size_t) pgettext_aux (NULL, context_keys[k], context_msgids[k],
+                                     LC_MESSAGES);
+      if (++k == n_context_keys)
+        k = 0;
+    }
+  report ("pgettext-hit", 1, (now () - start) / iterations * 1e9, "ns");
+
+  start = now ();
+  for (i = 0, k = 0; i < iterations; i++)
+    {
+      sink += (size_t) pgettext_expr (CONTEXT, context_msgids[k]);
+      if (++k == n_context_keys)
+        k = 0;
+    }
+  report ("pgettext-expr-hit", 1, (now () - start) / iterations * 1e9, "ns");
+}
+
+#if USE_POSIX_THREADS
+
+static void *
+lookup_thread (void *arg)
+{
+  unsigned long int i;
+  unsigned int k;
+
+  for (i = 0, k = (size_t) arg % n_hit_keys; i < iterations; i++)
+    {
+      sink += (size_t) gettext (hit_keys[k]);
+      if (++k == n_hit_keys)
+        k = 0;
+    }
+  return NULL;
+}
+
+/* Measure the throughput of gettext lookups in 1, 2, 4, ... threads, each
+   doing ITERATIONS lookups.  */
+static void
+bench_threads (void)
+{
+  pthread_t *threads =
+    (pthread_t *) xmalloc (max_threads * sizeof (pthread_t));
+  unsigned int n_threads;
+
+  for (n_threads = 1;; )
+    {
+      double start;
+      unsigned int t;
+
+      start = now ();
+      for (t = 0; t < n_threads; t++)
+        if (pthread_create (&threads[t], NULL, lookup_thread,
+                            (void *) (size_t) (t * 997)) != 0)
+          {
+            fputs ("bench-lookup: cannot create thread\n", stderr);
+            exit (1);
+          }
+      for (t = 0; t < n_threads; t++)
+        pthread_join (threads[t], NULL);
+      report ("gettext-hit-throughput", n_threads,
+              n_threads * iterations / (now () - start) / 1e6, "Mcalls/s");
+
+      if (n_threads == max_threads)
+        break;
+      n_threads =
+        (n_threads * 2 < max_threads ? n_threads * 2 : max_threads);
+    }
+
+  free (threads);
+}
+
+#endif
+
+
+static void
+usage (void)
+{
+  fputs ("\
+Usage: bench-lookup [OPTION]...\n\
+  -n NUMBER     number of messages in the catalog (default 10000)\n\
+  -p NUMBER     number of plural forms (default 2)\n\
+  -c CHARSET    charset of the catalog (default UTF-8)\n\
+  -i NUMBER     number of lookups per measurement (default 1000000)\n\
+  -l NUMBER     number of catalog loads (default 20)\n\
+  -t NUMBER     maximum number of threads (default 4)\n\
+  -d DIRECTORY  directory for the catalogs (default bench-lookup.d)\n",
+         stderr);
+  exit (1);
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct message *messages;
+  unsigned int count;
+  char *language_dir;
+  char *messages_dir;
+  char *file_name;
+  long rss_before;
+  long rss_after;
+  int c;
+
+  while ((c = getopt (argc, argv, "n:p:c:i:l:t:d:")) != -1)
+    switch (c)
+      {
+      case 'n':
+        n_messages = strtoul (optarg, NULL, 10);
+        break;
+      case 'p':
+        n_plurals = strtoul (optarg, NULL, 10);
+        break;
+      case 'c':
+        charset = optarg;
+        break;
+      case 'i':
+        iterations = strtoul (optarg, NULL, 10);
+        break;
+      case 'l':
+        n_loads = strtoul (optarg, NULL, 10);
+        break;
+      case 't':
+        max_threads = strtoul (optarg, NULL, 10);
+        break;
+      case 'd':
+        directory = optarg;
+        break;
+      default:
+        usage ();
+      }
+  if (optind < argc || n_messages < 4 || n_plurals < 1 || n_plurals > 100
+      || iterations == 0 || max_threads == 0)
+    usage ();
+
+  setlocale (LC_ALL, "");
+  putenv ((char *) "LANGUAGE=" LANGUAGE_NAME);
+
+  messages = make_messages (&count);
+
+  language_dir = (char *) xmalloc (strlen (directory) + 40);
+  sprintf (language_dir, "%s/%s", directory, LANGUAGE_NAME);
+  messages_dir = (char *) xmalloc (strlen (language_dir) + 40);
+  sprintf (messages_dir, "%s/LC_MESSAGES", language_dir);
+  make_directory (directory);
+  make_directory (language_dir);
+  make_directory (messages_dir);
+
+  printf ("# bench-lookup messages=%u plurals=%u charset=%s"
+          " locale=%s iterations=%lu\n",
+          n_messages, n_plurals, charset, setlocale (LC_MESSAGES, NULL),
+          iterations);
+
+  rss_before = resident_size ();
+
+  file_name =
+    (char *) xmalloc (strlen (messages_dir) + sizeof DOMAIN_NAME + 5);
+  sprintf (file_name, "%s/%s.mo", messages_dir, DOMAIN_NAME);
+  write_catalog (file_name, messages, count);
+  bindtextdomain (DOMAIN_NAME, directory);
+  textdomain (DOMAIN_NAME);
+
+  if (strcmp (gettext (hit_keys[0]), hit_keys[0]) == 0)
+    {
+      fprintf (stderr, "bench-lookup: no translation found in %s;"
+               " set LC_ALL to an installed locale other than C\n",
+               file_name);
+      exit (1);
+    }
+  check_catalog ();
+
+  bench_load (messages, count, messages_dir);
+  bench_gettext ("gettext-hit", hit_keys, n_hit_keys);
+  bench_gettext ("gettext-miss", miss_keys, n_miss_keys);
+  bench_ngettext ();
+  bench_pgettext ();
+#if USE_POSIX_THREADS
+  bench_threads ();
+#endif
+
+  rss_after = resident_size ();
+  if (rss_before >= 0 && rss_after >= 0)
+    report ("memory", 1, (double) (rss_after - rss_before), "KiB");
+
+  return 0;
+}
@@ -0,0 +1,553 @@
+/* Cache of parsed PO files.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "catalog-cache.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stat-time.h"
+#include "xalloc.h"
+#include "xvasprintf.h"
+
+
+/* Layout of a cache file.  All numbers are in the native byte order.
+
+   header:
+     8 bytes            magic "POCACHE\n"
+     uint32_t           CACHE_VERSION
+     uint32_t           0x01020304, to detect a foreign byte order
+     uint32_t           NFORMATS
+     uint32_t           NSYNTAXCHECKS
+     uint32_t           flags: 1 if allow_duplicates
+     uint64_t           device and inode number of the PO file
+     uint64_t           size of the PO file
+     int64_t            modification time of the PO file, in seconds
+     int32_t            and nanoseconds
+     uint32_t           number of domains
+   followed by, for each domain:
+     string             domain name
+     uint32_t           number of messages
+   followed by the messages of the domain, each:
+     string             msgctxt, msgid, msgid_plural, msgstr
+     string             prev_msgctxt, prev_msgid, prev_msgid_plural
+     uint64_t           line number of the message
+     uint32_t           number of comments, followed by the strings
+     uint32_t           number of extracted comments, followed by them
+     uint32_t           number of file positions, followed by, for each,
+                        a string and a uint64_t line number
+     uint8_t            is_fuzzy, obsolete, do_wrap
+     uint8_t[]          is_format[NFORMATS]
+     uint8_t[]          do_syntax_check[NSYNTAXCHECKS]
+     int32_t            range.min, range.max
+
+   A string is a uint32_t length N followed by N bytes and a NUL byte, or the
+   uint32_t 0xFFFFFFFF for a NULL string.  For msgstr, N is msgstr_len, which
+   includes the NUL bytes that separate and terminate the plural forms.  */
+
+static const char cache_magic[8] = { 'P', 'O', 'C', 'A', 'C', 'H', 'E', '\n' };
+
+#define CACHE_VERSION 2
+#define CACHE_BYTE_ORDER 0x01020304
+#define NULL_STRING ((uint32_t) 0xFFFFFFFF)
+
+
+bool
+catalog_cache_enabled ()
+{
+  const char *envval = getenv ("PO_FILE_CACHE");
+
+  return (envval != NULL && *envval != '\0');
+}
+
+
+/* ========================== Reading the cache. ========================== */
+
+/* A cursor into the contents of a cache file.  */
+struct cache_reader
+{
+  const char *p;
+  const char *end;
+};
+
+static bool
+get_bytes (struct cache_reader *r, void *buf, size_t n)
+{
+  if ((size_t) (r->end - r->p) < n)
+    return false;
+  memcpy (buf, r->p, n);
+  r->p += n;
+  return true;
+}
+
+static bool
+get_u8 (struct cache_reader *r, unsigned char *valuep)
+{
+  return get_bytes (r, valuep, 1);
+}
+
+static bool
+get_u32 (struct cache_reader *r, uint32_t *valuep)
+{
+  return get_bytes (r, valuep, sizeof (uint32_t));
+}
+
+static bool
+get_u64 (struct cache_reader *r, uint64_t *valuep)
+{
+  return get_bytes (r, valuep, sizeof (uint64_t));
+}
+
+/* Read a string.  Store a pointer to it, inside the cache contents, in
+   *STRINGP, and its length in *LENGTHP.  */
+static bool
+get_string (struct cache_reader *r, const char **stringp, size_t *lengthp)
+{
+  uint32_t length;
+
+  if (!get_u32 (r, &length))
+    return false;
+  if (length == NULL_STRING)
+    {
+      *stringp = NULL;
+      *lengthp = 0;
+      return true;
+    }
+  if ((size_t) (r->end - r->p) < (size_t) length + 1 || r->p[length] != '\0')
+    return false;
+  *stringp = r->p;
+  *lengthp = length;
+  r->p += (size_t) length + 1;
+  return true;
+}
+
+/* Read a string into freshly allocated memory.  */
+static bool
+get_string_copy (struct cache_reader *r, char **stringp)
+{
+  const char *s;
+  size_t length;
+
+  if (!get_string (r, &s, &length))
+    return false;
+  *stringp = (s != NULL ? (char *) xmemdup (s, length + 1) : NULL);
+  return true;
+}
+
+/* Read a list of comments into MP.  */
+static bool
+get_comments (struct cache_reader *r, message_ty *mp, bool dot)
+{
+  uint32_t n;
+  uint32_t i;
+
+  if (!get_u32 (r, &n))
+    return false;
+  for (i = 0; i < n; i++)
+    {
+      const char *s;
+      size_t length;
+
+      if (!get_string (r, &s, &length) || s == NULL)
+        return false;
+      if (dot)
+        message_comment_dot_append (mp, s);
+      else
+        message_comment_append (mp, s);
+    }
+  return true;
+}
+
+/* Read a message.  Return NULL if the cache is corrupt.  */
+static message_ty *
+get_message (struct cache_reader *r, lex_pos_ty *pos)
+{
+  char *msgctxt = NULL;
+  char *msgid = NULL;
+  char *msgid_plural = NULL;
+  const char *msgstr;
+  size_t msgstr_len;
+  message_ty *mp;
+  uint64_t line;
+  uint32_t n;
+  uint32_t i;
+  unsigned char flag;
+  int32_t range[2];
+
+  if (!get_string_copy (r, &msgctxt)
+      || !get_string_copy (r, &msgid) || msgid == NULL
+      || !get_string_copy (r, &msgid_plural)
+      || !get_string (r, &msgstr, &msgstr_len) || msgstr == NULL
+      || !get_u64 (r, &line))
+    {
+      free (msgctxt);
+      free (msgid);
+      free (msgid_plural);
+      return NULL;
+    }
+
+  pos->line_number = line;
+  mp = message_alloc (msgctxt, msgid, msgid_plural,
+                      xmemdup (msgstr, msgstr_len), msgstr_len, pos);
+  free (msgid_plural);
+
+  if (!get_string_copy (r, (char **) &mp->prev_msgctxt)
+      || !get_string_copy (r, (char **) &mp->prev_msgid)
+      || !get_string_copy (r, (char **) &mp->prev_msgid_plural)
+      || !get_comments (r, mp, false)
+      || !get_comments (r, mp, true)
+      || !get_u32 (r, &n))
+    goto corrupt;
+
+  if (n > 0)
+    {
+      if ((size_t) (r->end - r->p) / (sizeof (uint32_t) + 1) < n)
+        goto corrupt;
+      mp->filepos = XNMALLOC (n, lex_pos_ty);
+      for (i = 0; i < n; i++)
+        {
+          const char *file_name;
+          size_t length;
+
+          if (!get_string (r, &file_name, &length) || file_name == NULL
+              || !get_u64 (r, &line))
+            goto corrupt;
+          mp->filepos[i].file_name = xstrdup (file_name);
+          mp->filepos[i].line_number = line;
+          mp->filepos_count++;
+        }
+    }
+
+  if (!get_u8 (r, &flag))
+    goto corrupt;
+  mp->is_fuzzy = flag;
+  if (!get_u8 (r, &flag))
+    goto corrupt;
+  mp->obsolete = flag;
+  if (!get_u8 (r, &flag))
+    goto corrupt;
+  mp->do_wrap = (enum is_wrap) flag;
+  for (i = 0; i < NFORMATS; i++)
+    {
+      if (!get_u8 (r, &flag))
+        goto corrupt;
+      mp->is_format[i] = (enum is_format) flag;
+    }
+  for (i = 0; i < NSYNTAXCHECKS; i++)
+    {
+      if (!get_u8 (r, &flag))
+        goto corrupt;
+      mp->do_syntax_check[i] = (enum is_syntax_check) flag;
+    }
+  if (!get_bytes (r, range, sizeof (range)))
+    goto corrupt;
+  mp->range.min = range[0];
+  mp->range.max = range[1];
+
+  return mp;
+
+ corrupt:
+  message_free (mp);
+  return NULL;
+}
+
+/* Return the name of the cache file of REAL_FILENAME.  */
+static char *
+cache_filename (const char *real_filename)
+{
+  return xasprintf ("%s%s", real_filename, CATALOG_CACHE_SUFFIX);
+}
+
+msgdomain_list_ty *
+catalog_cache_read (FILE *fp, const char *real_filename,
+                    bool allow_duplicates)
+{
+  struct stat source_stat;
+  struct stat cache_stat;
+  char *filename;
+  FILE *cache_fp;
+  char *contents;
+  struct cache_reader r;
+  msgdomain_list_ty *mdlp;
+  lex_pos_ty pos;
+  char magic[sizeof (cache_magic)];
+  uint32_t value;
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  int64_t mtime;
+  int32_t mtime_ns;
+  uint32_t ndomains;
+  uint32_t d;
+
+  if (fstat (fileno (fp), &source_stat) < 0 || !S_ISREG (source_stat.st_mode))
+    return NULL;
+
+  filename = cache_filename (real_filename);
+  cache_fp = fopen (filename, "rb");
+  free (filename);
+  if (cache_fp == NULL)
+    return NULL;
+  if (fstat (fileno (cache_fp), &cache_stat) < 0
+      || !S_ISREG (cache_stat.st_mode)
+      || (off_t) (size_t) cache_stat.st_size != cache_stat.st_size)
+    {
+      fclose (cache_fp);
+      return NULL;
+    }
+
+  /* Read the entire cache file in one go.  */
+  contents = XNMALLOC (cache_stat.st_size + 1, char);
+  if (fread (contents, 1, cache_stat.st_size, cache_fp)
+      != (size_t) cache_stat.st_size)
+    {
+      fclose (cache_fp);
+      free (contents);
+      return NULL;
+    }
+  fclose (cache_fp);
+  r.p = contents;
+  r.end = contents + cache_stat.st_size;
+
+  /* Verify that the cache is usable and up to date.  */
+  mdlp = NULL;
+  if (!(get_bytes (&r, magic, sizeof (magic))
+        && memcmp (magic, cache_magic, sizeof (magic)) == 0
+        && get_u32 (&r, &value) && value == CACHE_VERSION
+        && get_u32 (&r, &value) && value == CACHE_BYTE_ORDER
+        && get_u32 (&r, &value) && value == NFORMATS
+        && get_u32 (&r, &value) && value == NSYNTAXCHECKS
+        && get_u32 (&r, &value) && value == (allow_duplicates ? 1 : 0)
+        && get_u64 (&r, &dev) && dev == (uint64_t) source_stat.st_dev
+        && get_u64 (&r, &ino) && ino == (uint64_t) source_stat.st_ino
+        && get_u64 (&r, &size) && size == (uint64_t) source_stat.st_size
+        && get_bytes (&r, &mtime, sizeof (mtime))
+        && mtime == (int64_t) source_stat.st_mtime
+        && get_bytes (&r, &mtime_ns, sizeof (mtime_ns))
+        && mtime_ns == (int32_t) get_stat_mtime_ns (&source_stat)
+        && get_u32 (&r, &ndomains)))
+    goto done;
+
+  /* The messages share their position's file name, like when the PO file is
+     parsed.  */
+  pos.file_name = xstrdup (real_filename);
+  pos.line_number = 0;
+
+  mdlp = msgdomain_list_alloc (!allow_duplicates);
+  for (d = 0; d < ndomains; d++)
+    {
+      const char *domain;
+      size_t length;
+      uint32_t nmessages;
+      message_list_ty *mlp;
+      uint32_t i;
+
+      if (!get_string (&r, &domain, &length) || domain == NULL
+          || !get_u32 (&r, &nmessages))
+        goto corrupt;
+      mlp =
+        msgdomain_list_sublist (mdlp,
+                                strcmp (domain, MESSAGE_DOMAIN_DEFAULT) == 0
+                                ? MESSAGE_DOMAIN_DEFAULT
+                                : xstrdup (domain),
+                                true);
+      if (nmessages > (size_t) (r.end - r.p))
+        goto corrupt;
+      message_list_reserve (mlp, nmessages);
+      for (i = 0; i < nmessages; i++)
+        {
+          message_ty *mp = get_message (&r, &pos);
+
+          if (mp == NULL)
+            goto corrupt;
+          if (mlp->use_hashtable
+              && message_list_search (mlp, mp->msgctxt, mp->msgid) != NULL)
+            {
+              message_free (mp);
+              goto corrupt;
+            }
+          message_list_append (mlp, mp);
+        }
+    }
+  if (r.p != r.end)
+    goto corrupt;
+
+ done:
+  free (contents);
+  return mdlp;
+
+ corrupt:
+  msgdomain_list_free (mdlp);
+  free (pos.file_name);
+  free (contents);
+  return NULL;
+}
+
+
+/* ========================== Writing the cache. ========================== */
+
+static void
+put_u32 (FILE *stream, uint32_t value)
+{
+  fwrite (&value, sizeof (value), 1, stream);
+}
+
+static void
+put_u64 (FILE *stream, uint64_t value)
+{
+  fwrite (&value, sizeof (value), 1, stream);
+}
+
+static void
+put_string_len (FILE *stream, const char *s, size_t length)
+{
+  if (s == NULL)
+    put_u32 (stream, NULL_STRING);
+  else
+    {
+      put_u32 (stream, length);
+      fwrite (s, 1, length, stream);
+      putc ('\0', stream);
+    }
+}
+
+static void
+put_string (FILE *stream, const char *s)
+{
+  put_string_len (stream, s, s != NULL ? strlen (s) : 0);
+}
+
+static void
+put_comments (FILE *stream, const string_list_ty *slp)
+{
+  if (slp == NULL)
+    put_u32 (stream, 0);
+  else
+    {
+      size_t j;
+
+      put_u32 (stream, slp->nitems);
+      for (j = 0; j < slp->nitems; j++)
+        put_string (stream, slp->item[j]);
+    }
+}
+
+static void
+put_message (FILE *stream, const message_ty *mp)
+{
+  int32_t range[2];
+  size_t j;
+
+  put_string (stream, mp->msgctxt);
+  put_string (stream, mp->msgid);
+  put_string (stream, mp->msgid_plural);
+  put_string_len (stream, mp->msgstr, mp->msgstr_len);
+  put_u64 (stream, mp->pos.line_number);
+  put_string (stream, mp->prev_msgctxt);
+  put_string (stream, mp->prev_msgid);
+  put_string (stream, mp->prev_msgid_plural);
+  put_comments (stream, mp->comment);
+  put_comments (stream, mp->comment_dot);
+  put_u32 (stream, mp->filepos_count);
+  for (j = 0; j < mp->filepos_count; j++)
+    {
+      put_string (stream, mp->filepos[j].file_name);
+      put_u64 (stream, mp->filepos[j].line_number);
+    }
+  putc (mp->is_fuzzy, stream);
+  putc (mp->obsolete, stream);
+  putc (mp->do_wrap, stream);
+  for (j = 0; j < NFORMATS; j++)
+    putc (mp->is_format[j], stream);
+  for (j = 0; j < NSYNTAXCHECKS; j++)
+    putc (mp->do_syntax_check[j], stream);
+  range[0] = mp->range.min;
+  range[1] = mp->range.max;
+  fwrite (range, sizeof (int32_t), 2, stream);
+}
+
+void
+catalog_cache_write (msgdomain_list_ty *mdlp,
+                     FILE *fp, const char *real_filename,
+                     bool allow_duplicates)
+{
+  struct stat source_stat;
+  char *filename;
+  char *tmp_filename;
+  FILE *stream;
+  int64_t mtime;
+  int32_t mtime_ns;
+  size_t k;
+
+  if (fstat (fileno (fp), &source_stat) < 0 || !S_ISREG (source_stat.st_mode))
+    return;
+  /* If the PO file was modified within the current second, a subsequent
+     modification might not change its modification time.  Don't cache
+     it yet.  */
+  if (source_stat.st_mtime >= time (NULL))
+    return;
+
+  /* Write a temporary file and rename it, so that concurrent readers
+     never see a partially written cache.  */
+  filename = cache_filename (real_filename);
+  tmp_filename = xasprintf ("%s.%ld.tmp", filename, (long) getpid ());
+  stream = fopen (tmp_filename, "wb");
+  if (stream == NULL)
+    goto done;
+
+  fwrite (cache_magic, 1, sizeof (cache_magic), stream);
+  put_u32 (stream, CACHE_VERSION);
+  put_u32 (stream, CACHE_BYTE_ORDER);
+  put_u32 (stream, NFORMATS);
+  put_u32 (stream, NSYNTAXCHECKS);
+  put_u32 (stream, allow_duplicates ? 1 : 0);
+  put_u64 (stream, source_stat.st_dev);
+  put_u64 (stream, source_stat.st_ino);
+  put_u64 (stream, source_stat.st_size);
+  mtime = source_stat.st_mtime;
+  fwrite (&mtime, sizeof (mtime), 1, stream);
+  mtime_ns = get_stat_mtime_ns (&source_stat);
+  fwrite (&mtime_ns, sizeof (mtime_ns), 1, stream);
+  put_u32 (stream, mdlp->nitems);
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      const message_list_ty *mlp = mdlp->item[k]->messages;
+      size_t j;
+
+      put_string (stream, mdlp->item[k]->domain);
+      put_u32 (stream, mlp->nitems);
+      for (j = 0; j < mlp->nitems; j++)
+        put_message (stream, mlp->item[j]);
+    }
+
+  if (ferror (stream) | (fclose (stream) != 0)
+      || rename (tmp_filename, filename) < 0)
+    unlink (tmp_filename);
+
+ done:
+  free (tmp_filename);
+  free (filename);
+}
@@ -0,0 +1,66 @@
+/* Cache of parsed PO files.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _CATALOG_CACHE_H
+#define _CATALOG_CACHE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "message.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* A PO file FILE.po can be accompanied by a cache file FILE.po.bin, which
+   contains the result of parsing FILE.po in a binary form that is much
+   faster to read.  The cache records the size and modification time of
+   FILE.po and is ignored as soon as FILE.po changes.  The cache is in the
+   native byte order and is meant for repeated invocations of the tools on
+   the same machine, e.g. during a build.  */
+
+/* Suffix appended to the name of a PO file to form its cache file name.  */
+#define CATALOG_CACHE_SUFFIX ".bin"
+
+/* Return true if the cache is enabled, through the environment variable
+   PO_FILE_CACHE.  */
+extern bool catalog_cache_enabled (void);
+
+/* Read the cache file of the PO file REAL_FILENAME, which is open as FP.
+   ALLOW_DUPLICATES is the value of allow_duplicates for which the cache is
+   requested.  Return the list of messages, or NULL if there is no up-to-date
+   cache.  */
+extern msgdomain_list_ty *
+       catalog_cache_read (FILE *fp, const char *real_filename,
+                           bool allow_duplicates);
+
+/* Write MDLP, the result of reading the PO file REAL_FILENAME that is open
+   as FP, into its cache file.  Failures are silently ignored.  */
+extern void
+       catalog_cache_write (msgdomain_list_ty *mdlp,
+                            FILE *fp, const char *real_filename,
+                            bool allow_duplicates);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* _CATALOG_CACHE_H */
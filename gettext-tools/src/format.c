@@ -25,8 +25,15 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 
 #include "message.h"
+#include "hash.h"
+#include "xalloc.h"
+#include "xmalloca.h"
 #include "gettext.h"
 
 #define _(str) gettext (str)
@@ -65,6 +72,118 @@ struct formatstring_parser *formatstring_parsers[NFORMATS] =
   /* format_arma */             &formatstring_arma
 };
 
+/* Whether parsed msgid descriptors are kept for reuse.  */
+bool format_reuse_msgid_descriptors = false;
+
+/* Cache of parsed msgid descriptors, used when
+   format_reuse_msgid_descriptors is true.  The key is a byte holding the
+   format type, followed by the msgid including its terminating NUL.  The
+   value is the descriptor, or NULL if the msgid is not a valid format
+   string.  The messages of a list may be checked in several threads; they
+   access the cache only in the critical section msgid_descr_cache.  */
+static hash_table msgid_descr_cache;
+
+/* Maximum number of entries in msgid_descr_cache.  When it is reached, the
+   cache is emptied and starts anew.  */
+#define MSGID_DESCR_CACHE_MAX 50000
+
+static void
+msgid_descr_cache_clear (void)
+{
+  void *iter = NULL;
+  const void *key;
+  size_t keylen;
+  void *data;
+
+  while (hash_iterate (&msgid_descr_cache, &iter, &key, &keylen, &data) == 0)
+    if (data != NULL)
+      formatstring_parsers[*(const unsigned char *) key]->free (data);
+  hash_destroy (&msgid_descr_cache);
+  msgid_descr_cache.table = NULL;
+}
+
+/* Parse STRING, a msgid, as a format string of type i.  Return the
+   descriptor, or NULL if STRING is not a valid format string.  Set *CACHEDP
+   to true if the descriptor is owned by the cache and must not be freed by
+   the caller.  */
+static void *
+parse_msgid_format (size_t i, const char *string, bool *cachedp)
+{
+  struct formatstring_parser *parser = formatstring_parsers[i];
+  char *invalid_reason = NULL;
+  size_t keylen;
+  char *key;
+  void *descr;
+
+  if (!format_reuse_msgid_descriptors)
+    {
+      *cachedp = false;
+      descr = parser->parse (string, false, NULL, &invalid_reason);
+      if (descr == NULL)
+        free (invalid_reason);
+      return descr;
+    }
+
+  keylen = 1 + strlen (string) + 1;
+  key = (char *) xmalloca (keylen);
+  key[0] = (char) i;
+  memcpy (key + 1, string, keylen - 1);
+
+  *cachedp = true;
+  #ifdef _OPENMP
+   #pragma omp critical (msgid_descr_cache)
+  #endif
+  {
+    if (msgid_descr_cache.table == NULL)
+      hash_init (&msgid_descr_cache, 1000);
+    if (hash_find_entry (&msgid_descr_cache, key, keylen, &descr) != 0)
+      *cachedp = false;
+  }
+
+  if (!*cachedp)
+    {
+      /* Parse outside of the critical section, so that other threads can
+         meanwhile look up other msgids.  */
+      descr = parser->parse (string, false, NULL, &invalid_reason);
+      if (descr == NULL)
+        free (invalid_reason);
+
+      #ifdef _OPENMP
+       #pragma omp critical (msgid_descr_cache)
+      #endif
+      {
+        bool in_parallel = false;
+
+        #ifdef _OPENMP
+        in_parallel = omp_in_parallel ();
+        #endif
+        /* Other threads may still use the cached descriptors.  Empty the
+           cache only when no other thread runs.  */
+        if (msgid_descr_cache.filled >= MSGID_DESCR_CACHE_MAX && !in_parallel)
+          {
+            msgid_descr_cache_clear ();
+            hash_init (&msgid_descr_cache, 1000);
+          }
+        if (msgid_descr_cache.filled < MSGID_DESCR_CACHE_MAX)
+          {
+            *cachedp = true;
+            if (hash_insert_entry (&msgid_descr_cache, key, keylen, descr)
+                == NULL)
+              {
+                /* Another thread has parsed the same msgid in the
+                   meantime.  Use its descriptor.  */
+                if (descr != NULL)
+                  parser->free (descr);
+                hash_find_entry (&msgid_descr_cache, key, keylen, &descr);
+              }
+          }
+      }
+    }
+
+  freea (key);
+  return descr;
+}
+
 /* Check whether both formats strings contain compatible format
    specifications for format type i (0 <= i < NFORMATS).  */
 int
@@ -90,9 +209,10 @@ check_msgid_msgstr_format_i (const char *msgid, const char *msgid_plural,
 
   struct formatstring_parser *parser = formatstring_parsers[i];
   char *invalid_reason = NULL;
+  bool msgid_descr_cached;
   void *msgid_descr =
-    parser->parse (msgid_plural != NULL ? msgid_plural : msgid, false, NULL,
-                   &invalid_reason);
+    parse_msgid_format (i, msgid_plural != NULL ? msgid_plural : msgid,
+                        &msgid_descr_cached);
 
   if (msgid_descr != NULL)
     {
@@ -159,10 +279,9 @@ check_msgid_msgstr_format_i (const char *msgid, const char *msgid_plural,
             }
         }
 
-      parser->free (msgid_descr);
+      if (!msgid_descr_cached)
+        parser->free (msgid_descr);
     }
-  else
-    free (invalid_reason);
 
   return seen_errors;
 }
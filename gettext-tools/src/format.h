@@ -146,6 +146,11 @@ extern void
    string.  */
 extern unsigned int get_python_format_unnamed_arg_count (const char *string);
 
+/* If true, check_msgid_msgstr_format_i and check_msgid_msgstr_format keep
+   the parsed msgid format strings and reuse them when the same msgid is
+   checked again, for example in another catalog.  Default: false.  */
+extern DLL_VARIABLE bool format_reuse_msgid_descriptors;
+
 /* Check whether both formats strings contain compatible format
    specifications for format type i (0 <= i < NFORMATS).
    Return the number of errors that were seen.  */
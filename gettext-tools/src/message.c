@@ -124,12 +124,27 @@ message_alloc (const char *msgctxt,
                const lex_pos_ty *pp)
 {
   message_ty *mp;
-  size_t i;
 
   mp = XMALLOC (message_ty);
+  message_init (mp, msgctxt, msgid,
+                (msgid_plural != NULL ? xstrdup (msgid_plural) : NULL),
+                msgstr, msgstr_len, pp);
+  return mp;
+}
+
+
+void
+message_init (message_ty *mp,
+              const char *msgctxt,
+              const char *msgid, const char *msgid_plural,
+              const char *msgstr, size_t msgstr_len,
+              const lex_pos_ty *pp)
+{
+  size_t i;
+
   mp->msgctxt = msgctxt;
   mp->msgid = msgid;
-  mp->msgid_plural = (msgid_plural != NULL ? xstrdup (msgid_plural) : NULL);
+  mp->msgid_plural = msgid_plural;
   mp->msgstr = msgstr;
   mp->msgstr_len = msgstr_len;
   mp->pos = *pp;
@@ -150,7 +165,6 @@ message_alloc (const char *msgctxt,
   mp->prev_msgid_plural = NULL;
   mp->used = 0;
   mp->obsolete = false;
-  return mp;
 }
 
 
@@ -298,6 +312,26 @@ message_list_free (message_list_ty *mlp, int keep_messages)
 }
 
 
+void
+message_list_reserve (message_list_ty *mlp, size_t n)
+{
+  if (mlp->nitems > 0)
+    return;
+
+  if (n > mlp->nitems_max)
+    {
+      mlp->nitems_max = n;
+      mlp->item = xrealloc (mlp->item, n * sizeof (message_ty *));
+    }
+  /* The hash table is resized when it becomes 75% full.  */
+  if (mlp->use_hashtable && 75 * mlp->htable.size < 100 * n)
+    {
+      hash_destroy (&mlp->htable);
+      hash_init (&mlp->htable, n + n / 3 + 1);
+    }
+}
+
+
 static int
 message_list_hash_insert_entry (hash_table *htable, message_ty *mp)
 {
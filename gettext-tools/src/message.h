@@ -231,6 +231,15 @@ extern message_ty *
                       const char *msgid, const char *msgid_plural,
                       const char *msgstr, size_t msgstr_len,
                       const lex_pos_ty *pp);
+/* Like message_alloc, but fills in a message_ty allocated by the caller,
+   and stores msgid_plural without copying it.  Messages initialized this
+   way must not be passed to message_free.  */
+extern void
+       message_init (message_ty *mp,
+                     const char *msgctxt,
+                     const char *msgid, const char *msgid_plural,
+                     const char *msgstr, size_t msgstr_len,
+                     const lex_pos_ty *pp);
 #define is_header(mp) ((mp)->msgctxt == NULL && (mp)->msgid[0] == '\0')
 extern void
        message_free (message_ty *mp);
@@ -265,6 +274,10 @@ extern message_list_ty *
    free the messages.  */
 extern void
        message_list_free (message_list_ty *mlp, int keep_messages);
+/* Prepare an empty message list to receive about N messages, so that
+   appending them does not need to grow its array and hash table.  */
+extern void
+       message_list_reserve (message_list_ty *mlp, size_t n);
 extern void
        message_list_append (message_list_ty *mlp, message_ty *mp);
 extern void
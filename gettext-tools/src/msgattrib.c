@@ -25,6 +25,7 @@
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <locale.h>
 
 #include "closeout.h"
@@ -133,6 +134,11 @@ static void usage (int status)
 static msgdomain_list_ty *process_msgdomain_list (msgdomain_list_ty *mdlp,
                                                   msgdomain_list_ty *only_mdlp,
                                                 msgdomain_list_ty *ignore_mdlp);
+static void process_catalog_streaming (const char *input_file,
+                                       catalog_input_format_ty input_syntax,
+                                       msgdomain_list_ty *only_mdlp,
+                                       msgdomain_list_ty *ignore_mdlp,
+                                       catalog_writer_ty *writer);
 
 
 int
@@ -148,6 +154,7 @@ main (int argc, char **argv)
   msgdomain_list_ty *only_mdlp;
   msgdomain_list_ty *ignore_mdlp;
   msgdomain_list_ty *result;
+  catalog_writer_ty *writer;
   catalog_input_format_ty input_syntax = &input_format_po;
   catalog_output_format_ty output_syntax = &output_format_po;
   bool sort_by_msgid = false;
@@ -383,6 +390,32 @@ There is NO WARRANTY, to the extent permitted by law.\n\
     error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
            "--sort-output", "--sort-by-file");
 
+  /* When the messages need not be sorted and go into a PO file on standard
+     output, process them one at a time, as they are read.  Then only the
+     msgids, for the detection of duplicates, the obsolete messages and the
+     messages of the domains after the first one are kept in memory, and
+     the output starts right away, which is useful in pipelines.  Output
+     into a named file is not done this way, so that an input error does not
+     leave a truncated output file behind.  */
+  if (!sort_by_filepos && !sort_by_msgid
+      && output_syntax == &output_format_po
+      && (output_file == NULL || strcmp (output_file, "-") == 0)
+      && (writer = catalog_writer_create (output_file, force_po, false))
+         != NULL)
+    {
+      only_mdlp = (only_file != NULL
+                   ? read_catalog_file (only_file, input_syntax)
+                   : NULL);
+      ignore_mdlp = (ignore_file != NULL
+                     ? read_catalog_file (ignore_file, input_syntax)
+                     : NULL);
+
+      process_catalog_streaming (input_file, input_syntax,
+                                 only_mdlp, ignore_mdlp, writer);
+
+      exit (EXIT_SUCCESS);
+    }
+
   /* Read input file.  */
   result = read_catalog_file (input_file, input_syntax);
 
@@ -581,6 +614,72 @@ is_message_selected (const message_ty *mp)
 }
 
 
+/* Change the attributes of MP.  */
+static void
+change_attributes (message_ty *mp,
+                   message_list_ty *only_mlp, message_list_ty *ignore_mlp)
+{
+  /* Attribute changes only affect messages listed in --only-file
+     and not listed in --ignore-file.  */
+  if ((only_mlp
+       ? message_list_search (only_mlp, mp->msgctxt, mp->msgid) != NULL
+       : true)
+      && (ignore_mlp
+          ? message_list_search (ignore_mlp, mp->msgctxt, mp->msgid) == NULL
+          : true))
+    {
+      if (to_change & SET_FUZZY)
+        {
+          if ((to_change & ADD_PREV) && !is_header (mp)
+              && !mp->is_fuzzy && mp->msgstr[0] != '\0')
+            {
+              mp->prev_msgctxt =
+                (mp->msgctxt != NULL ? xstrdup (mp->msgctxt) : NULL);
+              mp->prev_msgid =
+                (mp->msgid != NULL ? xstrdup (mp->msgid) : NULL);
+              mp->prev_msgid_plural =
+                (mp->msgid_plural != NULL
+                 ? xstrdup (mp->msgid_plural)
+                 : NULL);
+            }
+          mp->is_fuzzy = true;
+        }
+
+      if (to_change & RESET_FUZZY)
+        {
+          if ((to_change & REMOVE_TRANSLATION)
+              && mp->is_fuzzy && !mp->obsolete)
+            {
+              unsigned long int nplurals = 0;
+              char *msgstr;
+              size_t pos;
+
+              for (pos = 0; pos < mp->msgstr_len; ++pos)
+                if (!mp->msgstr[pos])
+                  ++nplurals;
+              free ((char *) mp->msgstr);
+              msgstr = XNMALLOC (nplurals, char);
+              memset (msgstr, '\0', nplurals);
+              mp->msgstr = msgstr;
+              mp->msgstr_len = nplurals;
+            }
+          mp->is_fuzzy = false;
+        }
+      /* Always keep the header entry non-obsolete.  */
+      if ((to_change & SET_OBSOLETE) && !is_header (mp))
+        mp->obsolete = true;
+      if (to_change & RESET_OBSOLETE)
+        mp->obsolete = false;
+      if (to_change & REMOVE_PREV)
+        {
+          mp->prev_msgctxt = NULL;
+          mp->prev_msgid = NULL;
+          mp->prev_msgid_plural = NULL;
+        }
+    }
+}
+
+
 static void
 process_message_list (message_list_ty *mlp,
                       message_list_ty *only_mlp, message_list_ty *ignore_mlp)
@@ -594,68 +693,7 @@ process_message_list (message_list_ty *mlp,
       size_t j;
 
       for (j = 0; j < mlp->nitems; j++)
-        {
-          message_ty *mp = mlp->item[j];
-
-          /* Attribute changes only affect messages listed in --only-file
-             and not listed in --ignore-file.  */
-          if ((only_mlp
-               ? message_list_search (only_mlp, mp->msgctxt, mp->msgid) != NULL
-               : true)
-              && (ignore_mlp
-                  ? message_list_search (ignore_mlp, mp->msgctxt, mp->msgid) == NULL
-                  : true))
-            {
-              if (to_change & SET_FUZZY)
-                {
-                  if ((to_change & ADD_PREV) && !is_header (mp)
-                      && !mp->is_fuzzy && mp->msgstr[0] != '\0')
-                    {
-                      mp->prev_msgctxt =
-                        (mp->msgctxt != NULL ? xstrdup (mp->msgctxt) : NULL);
-                      mp->prev_msgid =
-                        (mp->msgid != NULL ? xstrdup (mp->msgid) : NULL);
-                      mp->prev_msgid_plural =
-                        (mp->msgid_plural != NULL
-                         ? xstrdup (mp->msgid_plural)
-                         : NULL);
-                    }
-                  mp->is_fuzzy = true;
-                }
-
-              if (to_change & RESET_FUZZY)
-                {
-                  if ((to_change & REMOVE_TRANSLATION)
-                      && mp->is_fuzzy && !mp->obsolete)
-                    {
-                      unsigned long int nplurals = 0;
-                      char *msgstr;
-                      size_t pos;
-
-                      for (pos = 0; pos < mp->msgstr_len; ++pos)
-                        if (!mp->msgstr[pos])
-                          ++nplurals;
-                      free ((char *) mp->msgstr);
-                      msgstr = XNMALLOC (nplurals, char);
-                      memset (msgstr, '\0', nplurals);
-                      mp->msgstr = msgstr;
-                      mp->msgstr_len = nplurals;
-                    }
-                  mp->is_fuzzy = false;
-                }
-              /* Always keep the header entry non-obsolete.  */
-              if ((to_change & SET_OBSOLETE) && !is_header (mp))
-                mp->obsolete = true;
-              if (to_change & RESET_OBSOLETE)
-                mp->obsolete = false;
-              if (to_change & REMOVE_PREV)
-                {
-                  mp->prev_msgctxt = NULL;
-                  mp->prev_msgid = NULL;
-                  mp->prev_msgid_plural = NULL;
-                }
-            }
-        }
+        change_attributes (mlp->item[j], only_mlp, ignore_mlp);
     }
 }
 
@@ -682,3 +720,56 @@ process_msgdomain_list (msgdomain_list_ty *mdlp,
 
   return mdlp;
 }
+
+
+/* The state of process_catalog_streaming.  */
+struct streaming_state
+{
+  msgdomain_list_ty *only_mdlp;
+  msgdomain_list_ty *ignore_mdlp;
+  catalog_writer_ty *writer;
+};
+
+static void
+process_message_streaming (const char *domain, message_ty *mp, void *data)
+{
+  struct streaming_state *state = (struct streaming_state *) data;
+
+  if (!is_message_selected (mp))
+    {
+      catalog_writer_discard (state->writer, domain, mp);
+      return;
+    }
+
+  if (to_change)
+    change_attributes (mp,
+                       state->only_mdlp
+                       ? msgdomain_list_sublist (state->only_mdlp, domain, true)
+                       : NULL,
+                       state->ignore_mdlp
+                       ? msgdomain_list_sublist (state->ignore_mdlp, domain,
+                                                 false)
+                       : NULL);
+
+  catalog_writer_message (state->writer, domain, mp);
+}
+
+
+/* Filter the messages of INPUT_FILE and manipulate their attributes, like
+   process_msgdomain_list does, and write them to WRITER as they are read.  */
+static void
+process_catalog_streaming (const char *input_file,
+                           catalog_input_format_ty input_syntax,
+                           msgdomain_list_ty *only_mdlp,
+                           msgdomain_list_ty *ignore_mdlp,
+                           catalog_writer_ty *writer)
+{
+  struct streaming_state state;
+
+  state.only_mdlp = only_mdlp;
+  state.ignore_mdlp = ignore_mdlp;
+  state.writer = writer;
+  read_catalog_file_streaming (input_file, input_syntax,
+                               process_message_streaming, &state);
+  catalog_writer_close (writer);
+}
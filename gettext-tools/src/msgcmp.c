@@ -392,6 +392,9 @@ compare (const char *fn1, const char *fn2, catalog_input_format_ty input_syntax)
   const char *def_canon_charset;
   message_list_ty *empty_list;
 
+  /* Only the msgids and msgstrs are compared.  */
+  discard_comments = true;
+
   /* This is the master file, created by a human.  */
   def = remove_obsoletes (read_catalog_file (fn1, input_syntax));
 
@@ -125,6 +125,9 @@ static void usage (int status)
 ;
 static void generic_filter (const char *str, size_t len, char **resultp, size_t *lengthp);
 static msgdomain_list_ty *process_msgdomain_list (msgdomain_list_ty *mdlp);
+static void process_catalog_streaming (const char *input_file,
+                                       catalog_input_format_ty input_syntax,
+                                       catalog_writer_ty *writer);
 
 
 int
@@ -136,6 +139,7 @@ main (int argc, char **argv)
   char *output_file;
   const char *input_file;
   msgdomain_list_ty *result;
+  catalog_writer_ty *writer;
   catalog_input_format_ty input_syntax = &input_format_po;
   catalog_output_format_ty output_syntax = &output_format_po;
   bool sort_by_filepos = false;
@@ -345,38 +349,17 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   if (input_file == NULL)
     input_file = "-";
 
-  /* Read input file.  */
-  result = read_catalog_file (input_file, input_syntax);
-
   /* Recognize special programs as built-ins.  */
   if (strcmp (sub_name, "recode-sr-latin") == 0 && sub_argc == 1)
-    {
-      filter = serbian_to_latin;
-
-      /* Convert the input to UTF-8 first.  */
-      result = iconv_msgdomain_list (result, po_charset_utf8, true, input_file);
-    }
+    filter = serbian_to_latin;
   else if (strcmp (sub_name, "quot") == 0 && sub_argc == 1)
-    {
-      filter = ascii_quote_to_unicode;
-
-      /* Convert the input to UTF-8 first.  */
-      result = iconv_msgdomain_list (result, po_charset_utf8, true, input_file);
-    }
+    filter = ascii_quote_to_unicode;
   else if (strcmp (sub_name, "boldquot") == 0 && sub_argc == 1)
-    {
-      filter = ascii_quote_to_unicode_bold;
-
-      /* Convert the input to UTF-8 first.  */
-      result = iconv_msgdomain_list (result, po_charset_utf8, true, input_file);
-    }
+    filter = ascii_quote_to_unicode_bold;
   else
     {
       filter = generic_filter;
 
-      /* Warn if the current locale is not suitable for this PO file.  */
-      compare_po_locale_charsets (result);
-
       /* Attempt to locate the program.
          This is an optimization, to avoid that spawn/exec searches the PATH
          on every call.  */
@@ -386,6 +369,31 @@ There is NO WARRANTY, to the extent permitted by law.\n\
       sub_argv[0] = sub_path;
     }
 
+  /* When the messages need not be sorted and go into a PO file on standard
+     output, filter them one at a time, as they are read, like msgattrib
+     does.  The built-in filters need the whole catalog, because it has to
+     be converted to UTF-8 first.  */
+  if (filter == generic_filter
+      && !sort_by_filepos && !sort_by_msgid
+      && output_syntax == &output_format_po
+      && (output_file == NULL || strcmp (output_file, "-") == 0)
+      && (writer = catalog_writer_create (output_file, force_po, false))
+         != NULL)
+    {
+      process_catalog_streaming (input_file, input_syntax, writer);
+      exit (EXIT_SUCCESS);
+    }
+
+  /* Read input file.  */
+  result = read_catalog_file (input_file, input_syntax);
+
+  if (filter == generic_filter)
+    /* Warn if the current locale is not suitable for this PO file.  */
+    compare_po_locale_charsets (result);
+  else
+    /* Convert the input to UTF-8 first.  */
+    result = iconv_msgdomain_list (result, po_charset_utf8, true, input_file);
+
   /* Apply the subprogram.  */
   result = process_msgdomain_list (result);
 
@@ -798,3 +806,30 @@ process_msgdomain_list (msgdomain_list_ty *mdlp)
 
   return mdlp;
 }
+
+
+static void
+process_message_streaming (const char *domain, message_ty *mp, void *data)
+{
+  catalog_writer_ty *writer = (catalog_writer_ty *) data;
+
+  /* Warn if the current locale is not suitable for this PO file.  */
+  compare_po_locale_charsets_header (mp);
+
+  process_message (mp);
+  catalog_writer_message (writer, domain, mp);
+}
+
+
+/* Apply the subprogram to the messages of INPUT_FILE, like
+   process_msgdomain_list does, and write them to WRITER as they are read.  */
+static void
+process_catalog_streaming (const char *input_file,
+                           catalog_input_format_ty input_syntax,
+                           catalog_writer_ty *writer)
+{
+  read_catalog_file_streaming (input_file, input_syntax,
+                               process_message_streaming, writer);
+  compare_po_locale_charsets_end ();
+  catalog_writer_close (writer);
+}
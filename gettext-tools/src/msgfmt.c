@@ -21,6 +21,7 @@
 #endif
 
 #include <ctype.h>
+#include <errno.h>
 #include <getopt.h>
 #include <limits.h>
 #include <stdio.h>
@@ -30,6 +31,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <assert.h>
+#include <unistd.h>
+#if HAVE_WORKING_FORK
+# include <sys/wait.h>
+#endif
 
 #include "closeout.h"
 #include "str-list.h"
@@ -56,10 +61,12 @@
 #include "open-catalog.h"
 #include "read-catalog.h"
 #include "read-po.h"
+#include "po-lex.h"
 #include "read-properties.h"
 #include "read-stringtable.h"
 #include "read-desktop.h"
 #include "po-charset.h"
+#include "format.h"
 #include "msgl-check.h"
 #include "msgl-iconv.h"
 #include "concat-filename.h"
@@ -83,6 +90,13 @@ static bool include_untranslated = false;
 /* Specifies name of the output file.  */
 static const char *output_file_name;
 
+/* Batch mode output file specification.  */
+static bool batch_mode;
+static const char *batch_directory;
+static const char *bundle_file_name;
+/* The number of processes that compile the input files in batch mode.  */
+static unsigned int batch_jobs = 1;
+
 /* Java mode output file specification.  */
 static bool java_mode;
 static bool assume_java2;
@@ -179,28 +193,36 @@ static int do_statistics;
 static const struct option long_options[] =
 {
   { "alignment", required_argument, NULL, 'a' },
+  { "batch", no_argument, NULL, CHAR_MAX + 17 },
+  { "bundle", required_argument, NULL, CHAR_MAX + 20 },
   { "check", no_argument, NULL, 'c' },
   { "check-accelerators", optional_argument, NULL, CHAR_MAX + 1 },
   { "check-compatibility", no_argument, NULL, 'C' },
   { "check-domain", no_argument, NULL, CHAR_MAX + 2 },
   { "check-format", no_argument, NULL, CHAR_MAX + 3 },
   { "check-header", no_argument, NULL, CHAR_MAX + 4 },
+  { "compress", no_argument, NULL, CHAR_MAX + 22 },
   { "csharp", no_argument, NULL, CHAR_MAX + 10 },
   { "csharp-resources", no_argument, NULL, CHAR_MAX + 11 },
   { "desktop", no_argument, NULL, CHAR_MAX + 15 },
   { "directory", required_argument, NULL, 'D' },
   { "endianness", required_argument, NULL, CHAR_MAX + 13 },
+  { "expand-sysdep", no_argument, NULL, CHAR_MAX + 23 },
   { "help", no_argument, NULL, 'h' },
+  { "interleave", no_argument, NULL, CHAR_MAX + 18 },
   { "java", no_argument, NULL, 'j' },
   { "java2", no_argument, NULL, CHAR_MAX + 5 },
+  { "jobs", required_argument, NULL, CHAR_MAX + 24 },
   { "keyword", required_argument, NULL, 'k' },
   { "language", required_argument, NULL, 'L' },
   { "locale", required_argument, NULL, 'l' },
   { "no-hash", no_argument, NULL, CHAR_MAX + 6 },
   { "output-file", required_argument, NULL, 'o' },
+  { "perfect-hash", no_argument, NULL, CHAR_MAX + 19 },
   { "properties-input", no_argument, NULL, 'P' },
   { "qt", no_argument, NULL, CHAR_MAX + 9 },
   { "resource", required_argument, NULL, 'r' },
+  { "share-strings", no_argument, NULL, CHAR_MAX + 21 },
   { "source", no_argument, NULL, CHAR_MAX + 14 },
   { "statistics", no_argument, &do_statistics, 1 },
   { "strict", no_argument, NULL, 'S' },
@@ -225,8 +247,12 @@ static void usage (int status)
 static const char *add_mo_suffix (const char *);
 static struct msg_domain *new_domain (const char *name, const char *file_name);
 static bool is_nonobsolete (const message_ty *mp);
-static void read_catalog_file_msgfmt (char *filename,
-                                      catalog_input_format_ty input_syntax);
+static int read_catalog_file_msgfmt (char *filename,
+                                     catalog_input_format_ty input_syntax);
+static void msgfmt_batch_file (char *filename,
+                               catalog_input_format_ty input_syntax);
+static void msgfmt_batch_files (char **filenames, int nfilenames,
+                                catalog_input_format_ty input_syntax);
 static int msgfmt_desktop_bulk (const char *directory,
                                 const char *template_file_name,
                                 hash_table *keywords,
@@ -302,6 +328,7 @@ main (int argc, char *argv[])
         tcl_base_directory = optarg;
         desktop_base_directory = optarg;
         xml_base_directory = optarg;
+        batch_directory = optarg;
         break;
       case 'D':
         dir_list_append (optarg);
@@ -408,7 +435,7 @@ main (int argc, char *argv[])
       case CHAR_MAX + 12: /* --use-untranslated (undocumented) */
         include_untranslated = true;
         break;
-      case CHAR_MAX + 13: /* --endianness={big|little} */
+      case CHAR_MAX + 13: /* --endianness={big|little|native} */
         {
           int endianness;
 
@@ -416,6 +443,8 @@ main (int argc, char *argv[])
             endianness = 1;
           else if (strcmp (optarg, "little") == 0)
             endianness = 0;
+          else if (strcmp (optarg, "native") == 0)
+            endianness = ENDIANNESS;
           else
             error (EXIT_FAILURE, 0, _("invalid endianness: %s"), optarg);
 
@@ -432,6 +461,38 @@ main (int argc, char *argv[])
         desktop_template_name = optarg;
         xml_template_name = optarg;
         break;
+      case CHAR_MAX + 17: /* --batch */
+        batch_mode = true;
+        break;
+      case CHAR_MAX + 18: /* --interleave */
+        interleave_strings = true;
+        break;
+      case CHAR_MAX + 19: /* --perfect-hash */
+        perfect_hash_table = true;
+        break;
+      case CHAR_MAX + 20: /* --bundle=FILE */
+        batch_mode = true;
+        bundle_file_name = optarg;
+        break;
+      case CHAR_MAX + 24: /* --jobs=NUMBER */
+        {
+          char *endp;
+          unsigned long int n = strtoul (optarg, &endp, 10);
+
+          if (endp == optarg || *endp != '\0' || n == 0 || n > UINT_MAX)
+            error (EXIT_FAILURE, 0, _("invalid number of jobs: %s"), optarg);
+          batch_jobs = n;
+        }
+        break;
+      case CHAR_MAX + 21: /* --share-strings */
+        share_strings = true;
+        break;
+      case CHAR_MAX + 22: /* --compress */
+        compress_strings = true;
+        break;
+      case CHAR_MAX + 23: /* --expand-sysdep */
+        expand_sysdep_strings = true;
+        break;
       default:
         usage (EXIT_FAILURE);
         break;
@@ -483,10 +544,11 @@ There is NO WARRANTY, to the extent permitted by law.\n\
       | (tcl_mode ? 8 : 0)
       | (qt_mode ? 16 : 0)
       | (desktop_mode ? 32 : 0)
-      | (xml_mode ? 64 : 0);
+      | (xml_mode ? 64 : 0)
+      | (batch_mode ? 128 : 0);
     static const char *mode_options[] =
       { "--java", "--csharp", "--csharp-resources", "--tcl", "--qt",
-        "--desktop", "--xml" };
+        "--desktop", "--xml", "--batch" };
     /* More than one bit set?  */
     if (modes & (modes - 1))
       {
@@ -622,6 +684,30 @@ There is NO WARRANTY, to the extent permitted by law.\n\
     }
   else
     {
+      if (batch_mode)
+        {
+          if (output_file_name != NULL)
+            error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
+                   "--batch", "--output-file");
+          if (strict_uniforum)
+            error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
+                   "--batch", "--strict");
+          if (bundle_file_name != NULL && batch_directory != NULL)
+            error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
+                   "--bundle", "-d");
+        }
+      else if (batch_jobs > 1)
+        {
+          error (EXIT_SUCCESS, 0, _("%s is only valid with %s or %s"),
+                 "--jobs", "--batch", "--bundle");
+          usage (EXIT_FAILURE);
+        }
+      if (compress_strings && interleave_strings)
+        error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
+               "--compress", "--interleave");
+      if (compress_strings && share_strings)
+        error (EXIT_FAILURE, 0, _("%s and %s are mutually exclusive"),
+               "--compress", "--share-strings");
       if (java_resource_name != NULL)
         {
           error (EXIT_SUCCESS, 0, _("%s is only valid with %s or %s"),
@@ -634,7 +720,7 @@ There is NO WARRANTY, to the extent permitted by law.\n\
                  "--locale", "--java", "--csharp", "--tcl");
           usage (EXIT_FAILURE);
         }
-      if (java_class_directory != NULL)
+      if (java_class_directory != NULL && !batch_mode)
         {
           error (EXIT_SUCCESS, 0, _("%s is only valid with %s, %s or %s"),
                  "-d", "--java", "--csharp", "--tcl");
@@ -736,25 +822,47 @@ There is NO WARRANTY, to the extent permitted by law.\n\
       exit (exit_status);
     }
 
-  /* The -o option determines the name of the domain and therefore
-     the output file.  */
-  if (output_file_name != NULL)
-    current_domain =
-      new_domain (output_file_name,
-                  strict_uniforum && !csharp_resources_mode && !qt_mode
-                  ? add_mo_suffix (output_file_name)
-                  : output_file_name);
-
-  /* Process all given .po files.  */
-  for (arg_i = optind; arg_i < argc; arg_i++)
+  if (batch_mode)
     {
-      /* Remember that we currently have not specified any domain.  This
-         is of course not true when we saw the -o option.  */
-      if (output_file_name == NULL)
-        current_domain = NULL;
+      /* Catalogs compiled together usually share most of their msgids.
+         Parse the format strings in each msgid only once.  */
+      format_reuse_msgid_descriptors = true;
+
+      /* An input file with syntax errors is skipped, not the remaining
+         ones.  Report all errors in it, like msgmerge does.  */
+      gram_max_allowed_errors = UINT_MAX;
+
+      /* Compile each given .po file on its own.  This leaves no domain
+         for the code below.  */
+      msgfmt_batch_files (argv + optind, argc - optind, input_syntax);
 
-      /* And process the input file.  */
-      read_catalog_file_msgfmt (argv[arg_i], input_syntax);
+      /* Write the bundle only if all input files are free of errors.  */
+      if (bundle_file_name != NULL && exit_status == EXIT_SUCCESS)
+        if (bundle_write (bundle_file_name))
+          exit_status = EXIT_FAILURE;
+    }
+  else
+    {
+      /* The -o option determines the name of the domain and therefore
+         the output file.  */
+      if (output_file_name != NULL)
+        current_domain =
+          new_domain (output_file_name,
+                      strict_uniforum && !csharp_resources_mode && !qt_mode
+                      ? add_mo_suffix (output_file_name)
+                      : output_file_name);
+
+      /* Process all given .po files.  */
+      for (arg_i = optind; arg_i < argc; arg_i++)
+        {
+          /* Remember that we currently have not specified any domain.  This
+             is of course not true when we saw the -o option.  */
+          if (output_file_name == NULL)
+            current_domain = NULL;
+
+          /* And process the input file.  */
+          read_catalog_file_msgfmt (argv[arg_i], input_syntax);
+        }
     }
 
   /* We know a priori that some input_syntax->parse() functions convert
@@ -770,6 +878,11 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   {
     int nerrors = 0;
 
+    /* The domains of the input files usually share many msgids.  Parse the
+       format strings in each msgid only once.  */
+    if (domain_list != NULL && domain_list->next != NULL)
+      format_reuse_msgid_descriptors = true;
+
     for (domain = domain_list; domain != NULL; domain = domain->next)
       nerrors +=
         check_message_list (domain->mlp,
@@ -968,6 +1081,25 @@ Output file location:\n"));
 If output file is -, output is written to standard output.\n"));
       printf ("\n");
       printf (_("\
+Output file location in batch mode:\n"));
+      printf (_("\
+      --batch                 compile each input file into its own file\n"));
+      printf (_("\
+  -d DIRECTORY                directory of the output files\n"));
+      printf (_("\
+Each input file FILE.po is compiled into DIRECTORY/FILE.mo, or into FILE.mo\n\
+in the current directory if no -d option is given.  An output file is\n\
+replaced only when its input file has no errors.\n"));
+      printf (_("\
+      --bundle=FILE           store all catalogs in the bundle FILE\n"));
+      printf (_("\
+With --bundle, each input file LOCALE/DOMAIN.po is stored as the catalog\n\
+LOCALE/LC_MESSAGES/DOMAIN.mo in the bundle.  The bundle is written only when\n\
+no input file has errors.\n"));
+      printf (_("\
+      --jobs=NUMBER           compile NUMBER input files at a time\n"));
+      printf ("\n");
+      printf (_("\
 Output file location in Java mode:\n"));
       printf (_("\
   -r, --resource=RESOURCE     resource name\n"));
@@ -1072,9 +1204,23 @@ Output details:\n"));
   -a, --alignment=NUMBER      align strings to NUMBER bytes (default: %d)\n"), DEFAULT_OUTPUT_ALIGNMENT);
       printf (_("\
       --endianness=BYTEORDER  write out 32-bit numbers in the given byte order\n\
-                                (big or little, default depends on platform)\n"));
+                                (big, little or native, default: little)\n"));
       printf (_("\
       --no-hash               binary file will not include the hash table\n"));
+      printf (_("\
+      --interleave            store each translation next to its original\n\
+                                string in the binary file\n"));
+      printf (_("\
+      --perfect-hash          binary file will also include a perfect hash\n\
+                                table, for faster lookup\n"));
+      printf (_("\
+      --share-strings         store equal strings, and strings that end\n\
+                                another string, only once in the binary file\n"));
+      printf (_("\
+      --compress              compress the translations in the binary file\n"));
+      printf (_("\
+      --expand-sysdep         expand system dependent strings, such as\n\
+                                <PRIu64>, for this platform\n"));
       printf ("\n");
       printf (_("\
 Informative output:\n"));
@@ -1149,8 +1295,9 @@ is_nonobsolete (const message_ty *mp)
 /* The rest of the file defines a subclass msgfmt_catalog_reader_ty of
    default_catalog_reader_ty.  Its particularities are:
    - The header entry check is performed on-the-fly.
-   - Comments are not stored, they are discarded right away.
-     (This is achieved by setting handle_comments = false.)
+   - Comments and file positions are not stored, they are discarded right
+     away.  (This is achieved by setting handle_comments = false and
+     handle_filepos_comments = false.)
    - The multi-domain handling is adapted to our domain_list.
  */
 
@@ -1226,7 +1373,8 @@ msgfmt_set_domain (default_catalog_reader_ty *this, char *name)
   /* If no output file was given, we change it with each 'domain'
      directive.  */
   if (!java_mode && !csharp_mode && !csharp_resources_mode && !tcl_mode
-      && !qt_mode && !desktop_mode && !xml_mode && output_file_name == NULL)
+      && !qt_mode && !desktop_mode && !xml_mode && !batch_mode
+      && output_file_name == NULL)
     {
       size_t correct;
 
@@ -1400,16 +1548,26 @@ static default_catalog_reader_class_ty msgfmt_methods =
 };
 
 
-/* Read .po file FILENAME and store translation pairs.  */
-static void
+/* Read .po file FILENAME and store translation pairs.  In batch mode,
+   return the number of errors in it; otherwise errors are fatal.  */
+static int
 read_catalog_file_msgfmt (char *filename, catalog_input_format_ty input_syntax)
 {
   char *real_filename;
-  FILE *fp = open_catalog_file (filename, &real_filename, true);
+  FILE *fp = open_catalog_file (filename, &real_filename, !batch_mode);
   default_catalog_reader_ty *pop;
+  int nerrors;
+
+  if (fp == NULL)
+    {
+      error (0, errno, _("error while opening \"%s\" for reading"),
+             real_filename);
+      return 1;
+    }
 
   pop = default_catalog_reader_alloc (&msgfmt_methods);
   pop->handle_comments = false;
+  pop->handle_filepos_comments = false;
   pop->allow_domain_directives = true;
   pop->allow_duplicates = false;
   pop->allow_duplicates_if_same_msgstr = false;
@@ -1423,12 +1581,250 @@ read_catalog_file_msgfmt (char *filename, catalog_input_format_ty input_syntax)
       pop->mlp = current_domain->mlp;
     }
   po_lex_pass_obsolete_entries (true);
-  catalog_reader_parse ((abstract_catalog_reader_ty *) pop, fp, real_filename,
-                        filename, input_syntax);
+  if (batch_mode)
+    nerrors =
+      catalog_reader_parse_nonfatal ((abstract_catalog_reader_ty *) pop, fp,
+                                     real_filename, filename, input_syntax);
+  else
+    {
+      catalog_reader_parse ((abstract_catalog_reader_ty *) pop, fp,
+                            real_filename, filename, input_syntax);
+      nerrors = 0;
+    }
   catalog_reader_free ((abstract_catalog_reader_ty *) pop);
 
   if (fp != stdin)
     fclose (fp);
+
+  return nerrors;
+}
+
+
+/* Batch mode: Compile the .po file FILENAME into a .mo file with the same
+   base name in batch_directory.  The .mo file is replaced only if FILENAME
+   has no errors; otherwise the errors are reported and exit_status is set,
+   and the caller goes on with the next file.  With --bundle, FILENAME is
+   LOCALE/DOMAIN.po and its catalog is added to the bundle instead.  */
+static void
+msgfmt_batch_file (char *filename, catalog_input_format_ty input_syntax)
+{
+  const char *base = basename (filename);
+  size_t len = strlen (base);
+  char *name;
+  char *mo_file_name;
+  struct msg_domain *domain;
+  int nerrors;
+
+  if (len > 3 && memcmp (base + len - 3, ".po", 3) == 0)
+    len -= 3;
+  name = XNMALLOC (len + 1, char);
+  memcpy (name, base, len);
+  name[len] = '\0';
+  if (bundle_file_name != NULL)
+    {
+      /* The locale is the name of the directory containing FILENAME.  */
+      const char *locale_end = base;
+      const char *locale;
+
+      while (locale_end > filename && locale_end[-1] == '/')
+        locale_end--;
+      locale = locale_end;
+      while (locale > filename && locale[-1] != '/')
+        locale--;
+      if (locale == locale_end)
+        {
+          error (0, 0, _("\
+%s: input file is not in a directory named after a locale"),
+                 filename);
+          exit_status = EXIT_FAILURE;
+          free (name);
+          return;
+        }
+      mo_file_name = xasprintf ("%.*s/LC_MESSAGES/%s.mo",
+                                (int) (locale_end - locale), locale, name);
+    }
+  else
+    mo_file_name =
+      xconcatenated_filename (batch_directory != NULL ? batch_directory : ".",
+                              name, ".mo");
+
+  domain = current_domain = new_domain (name, mo_file_name);
+  nerrors = read_catalog_file_msgfmt (filename, input_syntax);
+
+  if (nerrors == 0)
+    {
+      /* Remove obsolete messages.  They were only needed for duplicate
+         checking.  */
+      message_list_remove_if_not (domain->mlp, is_nonobsolete);
+
+      nerrors =
+        check_message_list (domain->mlp, 0, 0,
+                            1, check_format_strings, check_header,
+                            check_compatibility,
+                            check_accelerators, accelerator_char);
+    }
+  if (nerrors > 0)
+    {
+      error (0, 0,
+             ngettext ("found %d fatal error", "found %d fatal errors",
+                       nerrors),
+             nerrors);
+      exit_status = EXIT_FAILURE;
+    }
+  else if (domain->mlp->nitems > 0)
+    {
+      if (bundle_file_name != NULL)
+        bundle_add_mo (domain->mlp, mo_file_name);
+      /* Pass the output file name as domain name, so that an input file
+         named "-" does not lead to output on standard output.  */
+      else if (msgdomain_write_mo (domain->mlp, mo_file_name, mo_file_name))
+        exit_status = EXIT_FAILURE;
+    }
+
+  message_list_free (domain->mlp, 0);
+  free (domain);
+  domain_list = NULL;
+  current_domain = NULL;
+  free (mo_file_name);
+  free (name);
+}
+
+#if HAVE_WORKING_FORK
+
+/* A process that compiles a part of the input files in batch mode.  */
+struct batch_job
+{
+  pid_t pid;
+  /* Its error messages, to be shown after those of the previous jobs.  */
+  FILE *diagnostics;
+  /* Its statistics and, with --bundle, the compiled catalogs.  */
+  FILE *results;
+};
+
+/* Compile the NFILENAMES files FILENAMES in NJOBS processes.  Each process
+   gets a contiguous part of the files.  Its error messages and results are
+   collected in temporary files and taken over in the order of the files,
+   so that the output is the same as with a single process.  */
+static void
+msgfmt_batch_files_parallel (char **filenames, int nfilenames,
+                             catalog_input_format_ty input_syntax,
+                             unsigned int njobs)
+{
+  struct batch_job *jobs = XNMALLOC (njobs, struct batch_job);
+  unsigned int j;
+
+  fflush (stdout);
+  fflush (stderr);
+
+  for (j = 0; j < njobs; j++)
+    {
+      int first = (int) ((unsigned long) nfilenames * j / njobs);
+      int last = (int) ((unsigned long) nfilenames * (j + 1) / njobs);
+
+      jobs[j].diagnostics = tmpfile ();
+      jobs[j].results = tmpfile ();
+      if (jobs[j].diagnostics == NULL || jobs[j].results == NULL)
+        error (EXIT_FAILURE, errno, _("cannot create a temporary file"));
+
+      jobs[j].pid = fork ();
+      if (jobs[j].pid < 0)
+        error (EXIT_FAILURE, errno, _("fork failed"));
+      if (jobs[j].pid == 0)
+        {
+          /* In the child process.  */
+          int i;
+
+          if (dup2 (fileno (jobs[j].diagnostics), STDERR_FILENO) < 0)
+            _exit (127);
+          for (i = first; i < last; i++)
+            msgfmt_batch_file (filenames[i], input_syntax);
+          fflush (stderr);
+
+          if (fwrite (&msgs_translated, sizeof (int), 1, jobs[j].results) != 1
+              || fwrite (&msgs_fuzzy, sizeof (int), 1, jobs[j].results) != 1
+              || fwrite (&msgs_untranslated, sizeof (int), 1,
+                         jobs[j].results) != 1
+              || (bundle_file_name != NULL
+                  ? bundle_write_members (jobs[j].results)
+                  : fflush (jobs[j].results) != 0))
+            exit_status = EXIT_FAILURE;
+          exit (exit_status);
+        }
+    }
+
+  for (j = 0; j < njobs; j++)
+    {
+      int status;
+      int counts[3];
+      char buf[4096];
+      size_t n;
+
+      while (waitpid (jobs[j].pid, &status, 0) < 0)
+        if (errno != EINTR)
+          error (EXIT_FAILURE, errno, _("waitpid failed"));
+
+      /* Show the error messages in the order of the input files.  */
+      rewind (jobs[j].diagnostics);
+      while ((n = fread (buf, 1, sizeof (buf), jobs[j].diagnostics)) > 0)
+        fwrite (buf, 1, n, stderr);
+      fflush (stderr);
+
+      if (!WIFEXITED (status))
+        {
+          error (0, 0, _("a subprocess terminated abnormally"));
+          exit_status = EXIT_FAILURE;
+        }
+      else
+        {
+          if (WEXITSTATUS (status) != 0)
+            exit_status = EXIT_FAILURE;
+
+          rewind (jobs[j].results);
+          if (fread (counts, sizeof (int), 3, jobs[j].results) == 3)
+            {
+              msgs_translated += counts[0];
+              msgs_fuzzy += counts[1];
+              msgs_untranslated += counts[2];
+              if (bundle_file_name != NULL
+                  && bundle_read_members (jobs[j].results))
+                exit_status = EXIT_FAILURE;
+            }
+          else
+            exit_status = EXIT_FAILURE;
+        }
+
+      fclose (jobs[j].diagnostics);
+      fclose (jobs[j].results);
+    }
+
+  free (jobs);
+}
+
+#endif
+
+/* Batch mode: Compile the NFILENAMES files FILENAMES, each on its own.
+   With --jobs, the files are compiled in several processes, not in threads:
+   the lexer and parser, the error counters and the check of the plural
+   formula (with its SIGFPE handler) all use global state.  */
+static void
+msgfmt_batch_files (char **filenames, int nfilenames,
+                    catalog_input_format_ty input_syntax)
+{
+  int i;
+
+#if HAVE_WORKING_FORK
+  if (batch_jobs > 1 && nfilenames > 1)
+    {
+      msgfmt_batch_files_parallel (filenames, nfilenames, input_syntax,
+                                   batch_jobs < (unsigned int) nfilenames
+                                   ? batch_jobs
+                                   : (unsigned int) nfilenames);
+      return;
+    }
+#endif
+
+  for (i = 0; i < nfilenames; i++)
+    msgfmt_batch_file (filenames[i], input_syntax);
 }
 
 static void
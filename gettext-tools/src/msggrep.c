@@ -142,6 +142,10 @@ static void usage (int status)
 #endif
 ;
 static msgdomain_list_ty *process_msgdomain_list (msgdomain_list_ty *mdlp);
+static void process_catalog_streaming (const char *input_file,
+                                       catalog_input_format_ty input_syntax,
+                                       bool check_charsets,
+                                       catalog_writer_ty *writer);
 
 
 int
@@ -153,7 +157,9 @@ main (int argc, char **argv)
   char *output_file;
   const char *input_file;
   int grep_pass;
+  bool have_patterns;
   msgdomain_list_ty *result;
+  catalog_writer_ty *writer;
   catalog_input_format_ty input_syntax = &input_format_po;
   catalog_output_format_ty output_syntax = &output_format_po;
   bool sort_by_filepos = false;
@@ -466,14 +472,30 @@ There is NO WARRANTY, to the extent permitted by law.\n\
         }
     }
 
+  have_patterns = (grep_task[0].pattern_count > 0
+                   || grep_task[1].pattern_count > 0
+                   || grep_task[2].pattern_count > 0
+                   || grep_task[3].pattern_count > 0
+                   || grep_task[4].pattern_count > 0);
+
+  /* When the messages need not be sorted and go into a PO file on standard
+     output, select them one at a time, as they are read, like msgattrib
+     does.  */
+  if (!sort_by_filepos && !sort_by_msgid
+      && output_syntax == &output_format_po
+      && (output_file == NULL || strcmp (output_file, "-") == 0)
+      && (writer = catalog_writer_create (output_file, force_po, false))
+         != NULL)
+    {
+      process_catalog_streaming (input_file, input_syntax, have_patterns,
+                                 writer);
+      exit (EXIT_SUCCESS);
+    }
+
   /* Read input file.  */
   result = read_catalog_file (input_file, input_syntax);
 
-  if (grep_task[0].pattern_count > 0
-      || grep_task[1].pattern_count > 0
-      || grep_task[2].pattern_count > 0
-      || grep_task[3].pattern_count > 0
-      || grep_task[4].pattern_count > 0)
+  if (have_patterns)
     {
       /* Warn if the current locale is not suitable for this PO file.  */
       compare_po_locale_charsets (result);
@@ -859,3 +881,46 @@ process_msgdomain_list (msgdomain_list_ty *mdlp)
 
   return mdlp;
 }
+
+
+/* The state of process_catalog_streaming.  */
+struct streaming_state
+{
+  bool check_charsets;
+  catalog_writer_ty *writer;
+};
+
+static void
+process_message_streaming (const char *domain, message_ty *mp, void *data)
+{
+  struct streaming_state *state = (struct streaming_state *) data;
+
+  if (state->check_charsets)
+    /* Warn if the current locale is not suitable for this PO file.  */
+    compare_po_locale_charsets_header (mp);
+
+  if (string_list_member (domain_names, domain) || is_message_selected (mp))
+    catalog_writer_message (state->writer, domain, mp);
+  else
+    catalog_writer_discard (state->writer, domain, mp);
+}
+
+
+/* Select the messages of INPUT_FILE, like process_msgdomain_list does, and
+   write them to WRITER as they are read.  */
+static void
+process_catalog_streaming (const char *input_file,
+                           catalog_input_format_ty input_syntax,
+                           bool check_charsets,
+                           catalog_writer_ty *writer)
+{
+  struct streaming_state state;
+
+  state.check_charsets = check_charsets;
+  state.writer = writer;
+  read_catalog_file_streaming (input_file, input_syntax,
+                               process_message_streaming, &state);
+  if (check_charsets)
+    compare_po_locale_charsets_end ();
+  catalog_writer_close (writer);
+}
@@ -43,92 +43,132 @@
 
 #define _(str) gettext (str)
 
-void
-compare_po_locale_charsets (const msgdomain_list_ty *mdlp)
+/* Check whether the locale encoding CANON_LOCALE_CODE and the encoding
+   declared in the header entry HEADER are the same.  Otherwise emit a
+   warning.  Return true if a warning was emitted.  */
+static bool
+compare_po_locale_charset (const char *header,
+                           const char *locale_code,
+                           const char *canon_locale_code)
 {
-  const char *locale_code;
-  const char *canon_locale_code;
-  bool warned;
-  size_t j, k;
+  const char *charsetstr = c_strstr (header, "charset=");
 
-  /* Check whether the locale encoding and the PO file's encoding are the
-     same.  Otherwise emit a warning.  */
-  locale_code = locale_charset ();
-  canon_locale_code = po_charset_canonicalize (locale_code);
-  warned = false;
-  for (k = 0; k < mdlp->nitems; k++)
+  if (charsetstr != NULL)
     {
-      const message_list_ty *mlp = mdlp->item[k]->messages;
-
-      for (j = 0; j < mlp->nitems; j++)
-        if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
-          {
-            const char *header = mlp->item[j]->msgstr;
-
-            if (header != NULL)
-              {
-                const char *charsetstr = c_strstr (header, "charset=");
-
-                if (charsetstr != NULL)
-                  {
-                    size_t len;
-                    char *charset;
-                    const char *canon_charset;
-
-                    charsetstr += strlen ("charset=");
-                    len = strcspn (charsetstr, " \t\n");
-                    charset = (char *) xmalloca (len + 1);
-                    memcpy (charset, charsetstr, len);
-                    charset[len] = '\0';
-
-                    canon_charset = po_charset_canonicalize (charset);
-                    if (canon_charset == NULL)
-                      error (EXIT_FAILURE, 0,
-                             _("\
+      size_t len;
+      char *charset;
+      const char *canon_charset;
+
+      charsetstr += strlen ("charset=");
+      len = strcspn (charsetstr, " \t\n");
+      charset = (char *) xmalloca (len + 1);
+      memcpy (charset, charsetstr, len);
+      charset[len] = '\0';
+
+      canon_charset = po_charset_canonicalize (charset);
+      if (canon_charset == NULL)
+        error (EXIT_FAILURE, 0,
+               _("\
 present charset \"%s\" is not a portable encoding name"),
-                             charset);
-                    freea (charset);
-                    if (canon_locale_code != canon_charset)
-                      {
-                        multiline_warning (xasprintf (_("warning: ")),
-                                           xasprintf (_("\
+               charset);
+      freea (charset);
+      if (canon_locale_code != canon_charset)
+        {
+          multiline_warning (xasprintf (_("warning: ")),
+                             xasprintf (_("\
 Locale charset \"%s\" is different from\n\
 input file charset \"%s\".\n\
 Output of '%s' might be incorrect.\n\
 Possible workarounds are:\n\
 "), locale_code, canon_charset, basename (program_name)));
-                        multiline_warning (NULL,
-                                           xasprintf (_("\
+          multiline_warning (NULL,
+                             xasprintf (_("\
 - Set LC_ALL to a locale with encoding %s.\n\
 "), canon_charset));
-                        if (canon_locale_code != NULL)
-                          multiline_warning (NULL,
-                                             xasprintf (_("\
+          if (canon_locale_code != NULL)
+            multiline_warning (NULL,
+                               xasprintf (_("\
 - Convert the translation catalog to %s using 'msgconv',\n\
   then apply '%s',\n\
   then convert back to %s using 'msgconv'.\n\
 "), canon_locale_code, basename (program_name), canon_charset));
-                        if (strcmp (canon_charset, "UTF-8") != 0
-                            && (canon_locale_code == NULL
-                                || strcmp (canon_locale_code, "UTF-8") != 0))
-                          multiline_warning (NULL,
-                                             xasprintf (_("\
+          if (strcmp (canon_charset, "UTF-8") != 0
+              && (canon_locale_code == NULL
+                  || strcmp (canon_locale_code, "UTF-8") != 0))
+            multiline_warning (NULL,
+                               xasprintf (_("\
 - Set LC_ALL to a locale with encoding %s,\n\
   convert the translation catalog to %s using 'msgconv',\n\
   then apply '%s',\n\
   then convert back to %s using 'msgconv'.\n\
 "), "UTF-8", "UTF-8", basename (program_name), canon_charset));
-                        warned = true;
-                      }
-                  }
-              }
-          }
-      }
-  if (canon_locale_code == NULL && !warned)
-    multiline_warning (xasprintf (_("warning: ")),
-                       xasprintf (_("\
+          return true;
+        }
+    }
+  return false;
+}
+
+/* Warn that the locale encoding LOCALE_CODE is not portable.  */
+static void
+warn_locale_charset_not_portable (const char *locale_code)
+{
+  multiline_warning (xasprintf (_("warning: ")),
+                     xasprintf (_("\
 Locale charset \"%s\" is not a portable encoding name.\n\
 Output of '%s' might be incorrect.\n\
 A possible workaround is to set LC_ALL=C.\n\
 "), locale_code, basename (program_name)));
 }
+
+void
+compare_po_locale_charsets (const msgdomain_list_ty *mdlp)
+{
+  const char *locale_code;
+  const char *canon_locale_code;
+  bool warned;
+  size_t j, k;
+
+  /* Check whether the locale encoding and the PO file's encoding are the
+     same.  Otherwise emit a warning.  */
+  locale_code = locale_charset ();
+  canon_locale_code = po_charset_canonicalize (locale_code);
+  warned = false;
+  for (k = 0; k < mdlp->nitems; k++)
+    {
+      const message_list_ty *mlp = mdlp->item[k]->messages;
+
+      for (j = 0; j < mlp->nitems; j++)
+        if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete
+            && mlp->item[j]->msgstr != NULL)
+          if (compare_po_locale_charset (mlp->item[j]->msgstr,
+                                         locale_code, canon_locale_code))
+            warned = true;
+    }
+  if (canon_locale_code == NULL && !warned)
+    warn_locale_charset_not_portable (locale_code);
+}
+
+/* Whether compare_po_locale_charsets_header has emitted a warning.  */
+static bool header_warned;
+
+void
+compare_po_locale_charsets_header (const message_ty *mp)
+{
+  if (is_header (mp) && !mp->obsolete && mp->msgstr != NULL)
+    {
+      const char *locale_code = locale_charset ();
+
+      if (compare_po_locale_charset (mp->msgstr, locale_code,
+                                     po_charset_canonicalize (locale_code)))
+        header_warned = true;
+    }
+}
+
+void
+compare_po_locale_charsets_end (void)
+{
+  const char *locale_code = locale_charset ();
+
+  if (po_charset_canonicalize (locale_code) == NULL && !header_warned)
+    warn_locale_charset_not_portable (locale_code);
+}
@@ -26,9 +26,19 @@ extern "C" {
 #endif
 
 
+/* Check whether the locale encoding and the encodings of the PO file MDLP
+   are the same.  Otherwise emit a warning.  */
 extern void
        compare_po_locale_charsets (const msgdomain_list_ty *mdlp);
 
+/* The same check, for programs that process the messages of a PO file as
+   they are read: call compare_po_locale_charsets_header for each message MP
+   as it is read, and compare_po_locale_charsets_end after the last one.  */
+extern void
+       compare_po_locale_charsets_header (const message_ty *mp);
+extern void
+       compare_po_locale_charsets_end (void);
+
 
 #ifdef __cplusplus
 }
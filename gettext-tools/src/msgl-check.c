@@ -69,20 +69,27 @@ plural_expression_histogram (const struct plural_distribution *self,
       unsigned long n;
       unsigned int count;
 
-      /* Protect against arithmetic exceptions.  */
-      install_sigfpe_handler ();
+      /* The SIGFPE handler is process-wide.  When the messages are checked
+         in several threads, let only one of them install it at a time.  */
+      #ifdef _OPENMP
+       #pragma omp critical (sigfpe_handler)
+      #endif
+      {
+        /* Protect against arithmetic exceptions.  */
+        install_sigfpe_handler ();
 
-      count = 0;
-      for (n = min; n <= max; n++)
-        {
-          unsigned long val = plural_eval (expr, n);
+        count = 0;
+        for (n = min; n <= max; n++)
+          {
+            unsigned long val = plural_eval (expr, n);
 
-          if (val == j)
-            count++;
-        }
+            if (val == j)
+              count++;
+          }
 
-      /* End of protection against arithmetic exceptions.  */
-      uninstall_sigfpe_handler ();
+        /* End of protection against arithmetic exceptions.  */
+        uninstall_sigfpe_handler ();
+      }
 
       return count;
     }
@@ -546,6 +553,9 @@ check_plural (message_list_ty *mlp,
 /* Signal an error when checking format strings.  */
 static const message_ty *curr_mp;
 static lex_pos_ty curr_msgid_pos;
+#ifdef _OPENMP
+ #pragma omp threadprivate (curr_mp, curr_msgid_pos)
+#endif
 static void
 formatstring_error_logger (const char *format, ...)
 #if defined __GNUC__ && ((__GNUC__ == 2 && __GNUC_MINOR__ >= 7) || __GNUC__ > 2)
@@ -874,6 +884,64 @@ check_message (const message_ty *mp,
 }
 
 
+#ifdef _OPENMP
+
+/* A problem that was signalled while checking a message in a thread.  */
+struct buffered_xerror
+{
+  int severity;
+  const message_ty *message;
+  const char *filename;
+  size_t lineno;
+  size_t column;
+  int multiline_p;
+  char *message_text;
+};
+
+/* The problems signalled while checking one message.  */
+struct buffered_xerrors
+{
+  struct buffered_xerror *items;
+  size_t nitems;
+  size_t nitems_max;
+};
+
+/* The problems of the message that the current thread checks.  */
+static struct buffered_xerrors *curr_xerrors;
+ #pragma omp threadprivate (curr_xerrors)
+
+/* A po_xerror handler that records the problem in curr_xerrors, so that
+   the problems can be reported in the order of the messages.  */
+static void
+buffering_xerror (int severity,
+                  const struct message_ty *message,
+                  const char *filename, size_t lineno, size_t column,
+                  int multiline_p, const char *message_text)
+{
+  struct buffered_xerrors *xerrors = curr_xerrors;
+  struct buffered_xerror *item;
+
+  if (xerrors->nitems == xerrors->nitems_max)
+    {
+      xerrors->nitems_max = 2 * xerrors->nitems_max + 2;
+      xerrors->items =
+        (struct buffered_xerror *)
+        xrealloc (xerrors->items,
+                  xerrors->nitems_max * sizeof (struct buffered_xerror));
+    }
+  item = &xerrors->items[xerrors->nitems++];
+  item->severity = severity;
+  item->message = message;
+  item->filename = filename;
+  item->lineno = lineno;
+  item->column = column;
+  item->multiline_p = multiline_p;
+  item->message_text = xstrdup (message_text);
+}
+
+#endif
+
+
 /* Perform all checks on a message list.
    Return the number of errors that were seen.  */
 int
@@ -899,6 +967,68 @@ check_message_list (message_list_ty *mlp,
     seen_errors += check_plural (mlp, ignore_untranslated_messages,
                                  ignore_fuzzy_messages, &distribution);
 
+#ifdef _OPENMP
+  if (mlp->nitems > 1)
+    {
+      /* Check the messages in several threads.  The problems are recorded
+         per message, and reported afterwards in the order of the messages,
+         as if the messages had been checked one after the other.  */
+      struct buffered_xerrors *xerrors =
+        (struct buffered_xerrors *)
+        xcalloc (mlp->nitems, sizeof (struct buffered_xerrors));
+      void (*old_po_xerror) (int, const struct message_ty *, const char *, size_t,
+                             size_t, int, const char *)
+        = po_xerror;
+      long int nn = mlp->nitems;
+      long int jj;
+
+      po_xerror = buffering_xerror;
+
+      /* The schedule is dynamic, because the checks of messages with
+         format strings take much longer than those of other messages.  */
+      #pragma omp parallel for schedule(dynamic, 16) reduction(+:seen_errors)
+      for (jj = 0; jj < nn; jj++)
+        {
+          message_ty *mp = mlp->item[jj];
+
+          if (!mp->obsolete
+              && !(ignore_untranslated_messages && mp->msgstr[0] == '\0')
+              && !(ignore_fuzzy_messages && (mp->is_fuzzy && !is_header (mp))))
+            {
+              curr_xerrors = &xerrors[jj];
+              seen_errors += check_message (mp, &mp->pos,
+                                            check_newlines,
+                                            check_format_strings,
+                                            &distribution,
+                                            check_header, check_compatibility,
+                                            check_accelerators,
+                                            accelerator_char);
+            }
+        }
+
+      po_xerror = old_po_xerror;
+
+      for (j = 0; j < mlp->nitems; j++)
+        {
+          size_t k;
+
+          for (k = 0; k < xerrors[j].nitems; k++)
+            {
+              struct buffered_xerror *item = &xerrors[j].items[k];
+
+              po_xerror (item->severity, item->message,
+                         item->filename, item->lineno, item->column,
+                         item->multiline_p, item->message_text);
+              free (item->message_text);
+            }
+          free (xerrors[j].items);
+        }
+      free (xerrors);
+
+      return seen_errors;
+    }
+#endif
+
   for (j = 0; j < mlp->nitems; j++)
     {
       message_ty *mp = mlp->item[j];
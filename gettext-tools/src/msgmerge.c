@@ -160,6 +160,7 @@ static void usage (int status)
 #endif
 ;
 static void compendium (const char *filename);
+static void backup (const char *filename);
 static void msgdomain_list_stablesort_by_obsolete (msgdomain_list_ty *mdlp);
 static msgdomain_list_ty *merge (const char *fn1, const char *fn2,
                                  catalog_input_format_ty input_syntax,
@@ -445,36 +446,14 @@ There is NO WARRANTY, to the extent permitted by law.\n\
       /* Do nothing if the original file and the result are equal.  Also do
          nothing if the original file and the result differ only by the
          POT-Creation-Date in the header entry; this is needed for projects
-         which don't put the .pot file under CVS.  */
+         which don't put the .pot file under CVS.  Also do nothing if the
+         differences are not visible in the output, for example in file
+         positions that are not written out: this keeps the time stamp of
+         the file, so that the files generated from it are not rebuilt.
+         Otherwise back up def.po and write the merged message list out.  */
       if (!msgdomain_list_equal (def, result, true))
-        {
-          /* Back up def.po.  */
-          enum backup_type backup_type;
-          char *backup_file;
-
-          output_file = argv[optind];
-
-          if (backup_suffix_string == NULL)
-            {
-              backup_suffix_string = getenv ("SIMPLE_BACKUP_SUFFIX");
-              if (backup_suffix_string != NULL
-                  && backup_suffix_string[0] == '\0')
-                backup_suffix_string = NULL;
-            }
-          if (backup_suffix_string != NULL)
-            simple_backup_suffix = backup_suffix_string;
-
-          backup_type = xget_version (_("backup type"), version_control_string);
-          if (backup_type != none)
-            {
-              backup_file = find_backup_file_name (output_file, backup_type);
-              copy_file_preserving (output_file, backup_file);
-            }
-
-          /* Write the merged message list out.  */
-          msgdomain_list_print (result, output_file, output_syntax, true,
-                                false);
-        }
+        msgdomain_list_print_if_changed (result, argv[optind], output_syntax,
+                                         false, backup);
     }
   else
     {
@@ -487,6 +466,33 @@ There is NO WARRANTY, to the extent permitted by law.\n\
 }
 
 
+/* Back up the file FILENAME before it is replaced, as requested by the
+   --backup and --suffix options.  */
+static void
+backup (const char *filename)
+{
+  enum backup_type backup_type;
+  char *backup_file;
+
+  if (backup_suffix_string == NULL)
+    {
+      backup_suffix_string = getenv ("SIMPLE_BACKUP_SUFFIX");
+      if (backup_suffix_string != NULL
+          && backup_suffix_string[0] == '\0')
+        backup_suffix_string = NULL;
+    }
+  if (backup_suffix_string != NULL)
+    simple_backup_suffix = backup_suffix_string;
+
+  backup_type = xget_version (_("backup type"), version_control_string);
+  if (backup_type != none)
+    {
+      backup_file = find_backup_file_name (filename, backup_type);
+      copy_file_preserving (filename, backup_file);
+    }
+}
+
+
 /* Display usage information and exit.  */
 static void
 usage (int status)
@@ -1977,6 +1983,11 @@ merge (const char *fn1, const char *fn2, catalog_input_format_ty input_syntax,
          the definition domains.  */
       message_list_ty *refmlp = ref->item[0]->messages;
 
+      /* The format strings of the same reference messages may be checked
+         for each of the definition domains.  Parse them only once.  */
+      if (def->nitems > 1)
+        format_reuse_msgid_descriptors = true;
+
       for (k = 0; k < def->nitems; k++)
         {
           const char *domain = def->item[k]->domain;
@@ -30,7 +30,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "str-list.h"
 #include "po-lex.h"
 #include "po-charset.h"
 #include "error.h"
@@ -112,6 +111,25 @@ do_callback_message (char *msgctxt,
                        false, obsolete);
 }
 
+/* Append the string S to the growable buffer *BUFP, which currently holds
+   *LENP bytes (plus a NUL) in *ALLOCATEDP bytes of storage, and free S.
+   Multi-line strings are thus accumulated in place, instead of as a list of
+   lines that needs to be concatenated afterwards.  */
+static void
+string_buffer_append (char **bufp, size_t *lenp, size_t *allocatedp, char *s)
+{
+  size_t s_len = strlen (s);
+
+  if (*lenp + s_len + 1 > *allocatedp)
+    {
+      *allocatedp = 2 * *allocatedp + s_len + 1;
+      *bufp = (char *) xrealloc (*bufp, *allocatedp);
+    }
+  memcpy (*bufp + *lenp, s, s_len + 1);
+  *lenp += s_len;
+  free (s);
+}
+
 #define free_message_intro(value) \
   if ((value).prev_ctxt != NULL)        \
     free ((value).prev_ctxt);           \
@@ -143,7 +161,7 @@ do_callback_message (char *msgctxt,
 %union
 {
   struct { char *string; lex_pos_ty pos; bool obsolete; } string;
-  struct { string_list_ty stringlist; lex_pos_ty pos; bool obsolete; } stringlist;
+  struct { char *string; size_t len; size_t allocated; lex_pos_ty pos; bool obsolete; } stringbuf;
   struct { long number; lex_pos_ty pos; bool obsolete; } number;
   struct { lex_pos_ty pos; bool obsolete; } pos;
   struct { char *ctxt; char *id; char *id_plural; lex_pos_ty pos; bool obsolete; } prev;
@@ -153,7 +171,7 @@ do_callback_message (char *msgctxt,
 
 %type <string> STRING PREV_STRING COMMENT NAME
                msg_intro prev_msg_intro msgid_pluralform prev_msgid_pluralform
-%type <stringlist> string_list prev_string_list
+%type <stringbuf> string_list prev_string_list
 %type <number> NUMBER
 %type <pos> DOMAIN
             PREV_MSGCTXT PREV_MSGID PREV_MSGID_PLURAL
@@ -194,15 +212,15 @@ domain
 message
         : message_intro string_list MSGSTR string_list
                 {
-                  char *string2 = string_list_concat_destroy (&$2.stringlist);
-                  char *string4 = string_list_concat_destroy (&$4.stringlist);
+                  char *string2 = $2.string;
+                  char *string4 = $4.string;
 
                   check_obsolete ($1, $2);
                   check_obsolete ($1, $3);
                   check_obsolete ($1, $4);
                   if (!$1.obsolete || pass_obsolete_entries)
                     do_callback_message ($1.ctxt, string2, &$1.pos, NULL,
-                                         string4, strlen (string4) + 1, &$3.pos,
+                                         string4, $4.len + 1, &$3.pos,
                                          $1.prev_ctxt,
                                          $1.prev_id, $1.prev_id_plural,
                                          $1.obsolete);
@@ -215,7 +233,7 @@ message
                 }
         | message_intro string_list msgid_pluralform pluralform_list
                 {
-                  char *string2 = string_list_concat_destroy (&$2.stringlist);
+                  char *string2 = $2.string;
 
                   check_obsolete ($1, $2);
                   check_obsolete ($1, $3);
@@ -243,7 +261,7 @@ message
                   check_obsolete ($1, $3);
                   po_gram_error_at_line (&$1.pos, _("missing 'msgstr[]' section"));
                   free_message_intro ($1);
-                  string_list_destroy (&$2.stringlist);
+                  free ($2.string);
                   free ($3.string);
                 }
         | message_intro string_list pluralform_list
@@ -252,7 +270,7 @@ message
                   check_obsolete ($1, $3);
                   po_gram_error_at_line (&$1.pos, _("missing 'msgid_plural' section"));
                   free_message_intro ($1);
-                  string_list_destroy (&$2.stringlist);
+                  free ($2.string);
                   free ($3.rhs.msgstr);
                 }
         | message_intro string_list
@@ -260,7 +278,7 @@ message
                   check_obsolete ($1, $2);
                   po_gram_error_at_line (&$1.pos, _("missing 'msgstr' section"));
                   free_message_intro ($1);
-                  string_list_destroy (&$2.stringlist);
+                  free ($2.string);
                 }
         ;
 
@@ -293,7 +311,7 @@ prev
                 {
                   check_obsolete ($1, $2);
                   $$.ctxt = $1.string;
-                  $$.id = string_list_concat_destroy (&$2.stringlist);
+                  $$.id = $2.string;
                   $$.id_plural = NULL;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
@@ -303,7 +321,7 @@ prev
                   check_obsolete ($1, $2);
                   check_obsolete ($1, $3);
                   $$.ctxt = $1.string;
-                  $$.id = string_list_concat_destroy (&$2.stringlist);
+                  $$.id = $2.string;
                   $$.id_plural = $3.string;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
@@ -322,7 +340,7 @@ msg_intro
                 {
                   check_obsolete ($1, $2);
                   check_obsolete ($1, $3);
-                  $$.string = string_list_concat_destroy (&$2.stringlist);
+                  $$.string = $2.string;
                   $$.pos = $3.pos;
                   $$.obsolete = $3.obsolete;
                 }
@@ -339,7 +357,7 @@ prev_msg_intro
                 {
                   check_obsolete ($1, $2);
                   check_obsolete ($1, $3);
-                  $$.string = string_list_concat_destroy (&$2.stringlist);
+                  $$.string = $2.string;
                   $$.pos = $3.pos;
                   $$.obsolete = $3.obsolete;
                 }
@@ -351,7 +369,7 @@ msgid_pluralform
                 {
                   check_obsolete ($1, $2);
                   plural_counter = 0;
-                  $$.string = string_list_concat_destroy (&$2.stringlist);
+                  $$.string = $2.string;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
@@ -361,7 +379,7 @@ prev_msgid_pluralform
         : PREV_MSGID_PLURAL prev_string_list
                 {
                   check_obsolete ($1, $2);
-                  $$.string = string_list_concat_destroy (&$2.stringlist);
+                  $$.string = $2.string;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
@@ -376,11 +394,9 @@ pluralform_list
         | pluralform_list pluralform
                 {
                   check_obsolete ($1, $2);
-                  $$.rhs.msgstr = XNMALLOC ($1.rhs.msgstr_len + $2.rhs.msgstr_len, char);
-                  memcpy ($$.rhs.msgstr, $1.rhs.msgstr, $1.rhs.msgstr_len);
+                  $$.rhs.msgstr = (char *) xrealloc ($1.rhs.msgstr, $1.rhs.msgstr_len + $2.rhs.msgstr_len);
                   memcpy ($$.rhs.msgstr + $1.rhs.msgstr_len, $2.rhs.msgstr, $2.rhs.msgstr_len);
                   $$.rhs.msgstr_len = $1.rhs.msgstr_len + $2.rhs.msgstr_len;
-                  free ($1.rhs.msgstr);
                   free ($2.rhs.msgstr);
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
@@ -402,8 +418,8 @@ pluralform
                         po_gram_error_at_line (&$1.pos, _("plural form has wrong index"));
                     }
                   plural_counter++;
-                  $$.rhs.msgstr = string_list_concat_destroy (&$5.stringlist);
-                  $$.rhs.msgstr_len = strlen ($$.rhs.msgstr) + 1;
+                  $$.rhs.msgstr = $5.string;
+                  $$.rhs.msgstr_len = $5.len + 1;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
@@ -413,18 +429,20 @@ pluralform
 string_list
         : STRING
                 {
-                  string_list_init (&$$.stringlist);
-                  string_list_append (&$$.stringlist, $1.string);
-                  free ($1.string);
+                  $$.string = $1.string;
+                  $$.len = strlen ($1.string);
+                  $$.allocated = $$.len + 1;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
         | string_list STRING
                 {
                   check_obsolete ($1, $2);
-                  $$.stringlist = $1.stringlist;
-                  string_list_append (&$$.stringlist, $2.string);
-                  free ($2.string);
+                  $$.string = $1.string;
+                  $$.len = $1.len;
+                  $$.allocated = $1.allocated;
+                  string_buffer_append (&$$.string, &$$.len, &$$.allocated,
+                                        $2.string);
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
@@ -433,18 +451,20 @@ string_list
 prev_string_list
         : PREV_STRING
                 {
-                  string_list_init (&$$.stringlist);
-                  string_list_append (&$$.stringlist, $1.string);
-                  free ($1.string);
+                  $$.string = $1.string;
+                  $$.len = strlen ($1.string);
+                  $$.allocated = $$.len + 1;
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
         | prev_string_list PREV_STRING
                 {
                   check_obsolete ($1, $2);
-                  $$.stringlist = $1.stringlist;
-                  string_list_append (&$$.stringlist, $2.string);
-                  free ($2.string);
+                  $$.string = $1.string;
+                  $$.len = $1.len;
+                  $$.allocated = $1.allocated;
+                  string_buffer_append (&$$.string, &$$.len, &$$.allocated,
+                                        $2.string);
                   $$.pos = $1.pos;
                   $$.obsolete = $1.obsolete;
                 }
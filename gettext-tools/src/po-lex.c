@@ -368,6 +368,24 @@ mbfile_init (mbfile_t mbf, FILE *stream)
   mbf->bufcount = 0;
 }
 
+/* Return true if, in the PO file's encoding, every byte in the range
+   0x00..0x7F is a character on its own and has the same meaning as in
+   ASCII.  */
+static bool
+lex_ascii_compatible ()
+{
+  static const char *cached_charset;
+  static bool cached_result = true;
+
+  if (po_lex_charset != cached_charset)
+    {
+      cached_charset = po_lex_charset;
+      cached_result = (po_lex_charset == NULL
+                       || po_charset_ascii_compatible (po_lex_charset));
+    }
+  return cached_result;
+}
+
 /* Read the next multibyte character from mbf and put it into mbc.
    If a read error occurs, errno is set and ferror (mbf->fp) becomes true.  */
 static void
@@ -404,112 +422,136 @@ mbfile_getc (mbchar_t mbc, mbfile_t mbf)
 #if HAVE_ICONV
   if (po_lex_iconv != (iconv_t)(-1))
     {
+      /* In ASCII compatible encodings, a byte in the range 0x00..0x7F is
+         a character on its own.  Don't bother iconv with it.  */
+      if ((unsigned char) mbf->buf[0] < 0x80 && lex_ascii_compatible ())
+        {
+          bytes = 1;
+          mbc->uc = (unsigned char) mbf->buf[0];
+          mbc->uc_valid = true;
+        }
+      else
       /* Use iconv on an increasing number of bytes.  Read only as many
          bytes from mbf->fp as needed.  This is needed to give reasonable
          interactive behaviour when mbf->fp is connected to an interactive
          tty.  */
       for (;;)
         {
-          unsigned char scratchbuf[64];
-          const char *inptr = &mbf->buf[0];
-          size_t insize = mbf->bufcount;
-          char *outptr = (char *) &scratchbuf[0];
-          size_t outsize = sizeof (scratchbuf);
-
-          size_t res = iconv (po_lex_iconv,
-                              (ICONV_CONST char **) &inptr, &insize,
-                              &outptr, &outsize);
-          /* We expect that a character has been produced if and only if
-             some input bytes have been consumed.  */
-          if ((insize < mbf->bufcount) != (outsize < sizeof (scratchbuf)))
-            abort ();
-          if (outsize == sizeof (scratchbuf))
+          if (po_lex_charset == po_charset_utf8)
             {
-              /* No character has been produced.  Must be an error.  */
-              if (res != (size_t)(-1))
-                abort ();
-
-              if (errno == EILSEQ)
+              /* The PO file is already in UTF-8.  Decode it directly,
+                 with the same error semantics as iconv.  */
+              int n = u8_mbtoucr (&mbc->uc, (const unsigned char *) mbf->buf,
+                                  mbf->bufcount);
+              if (n >= 0)
                 {
-                  /* An invalid multibyte sequence was encountered.  */
-                  /* Return a single byte.  */
-                  if (signal_eilseq)
-                    po_gram_error (_("invalid multibyte sequence"));
-                  bytes = 1;
-                  mbc->uc_valid = false;
+                  bytes = n;
+                  mbc->uc_valid = true;
                   break;
                 }
-              else if (errno == EINVAL)
+              errno = (n == -2 ? EINVAL : EILSEQ);
+            }
+          else
+            {
+              unsigned char scratchbuf[64];
+              const char *inptr = &mbf->buf[0];
+              size_t insize = mbf->bufcount;
+              char *outptr = (char *) &scratchbuf[0];
+              size_t outsize = sizeof (scratchbuf);
+
+              size_t res = iconv (po_lex_iconv,
+                                  (ICONV_CONST char **) &inptr, &insize,
+                                  &outptr, &outsize);
+              /* We expect that a character has been produced if and only if
+                 some input bytes have been consumed.  */
+              if ((insize < mbf->bufcount) != (outsize < sizeof (scratchbuf)))
+                abort ();
+              if (outsize < sizeof (scratchbuf))
                 {
-                  /* An incomplete multibyte character.  */
-                  int c;
-
-                  if (mbf->bufcount == MBCHAR_BUF_SIZE)
-                    {
-                      /* An overlong incomplete multibyte sequence was
-                         encountered.  */
-                      /* Return a single byte.  */
-                      bytes = 1;
-                      mbc->uc_valid = false;
-                      break;
-                    }
-
-                  /* Read one more byte and retry iconv.  */
-                  c = getc (mbf->fp);
-                  if (c == EOF)
-                    {
-                      mbf->eof_seen = true;
-                      if (ferror (mbf->fp))
-                        goto eof;
-                      if (signal_eilseq)
-                        po_gram_error (_("\
-incomplete multibyte sequence at end of file"));
-                      bytes = mbf->bufcount;
-                      mbc->uc_valid = false;
-                      break;
-                    }
-                  mbf->buf[mbf->bufcount++] = (unsigned char) c;
-                  if (c == '\n')
+                  size_t outbytes = sizeof (scratchbuf) - outsize;
+                  bytes = mbf->bufcount - insize;
+
+                  /* We expect that one character has been produced.  */
+                  if (bytes == 0)
+                    abort ();
+                  if (outbytes == 0)
+                    abort ();
+                  /* Convert it from UTF-8 to UCS-4.  */
+                  if (u8_mbtoucr (&mbc->uc, scratchbuf, outbytes)
+                      < (int) outbytes)
                     {
+                      /* scratchbuf contains an out-of-range Unicode character
+                         (> 0x10ffff).  */
                       if (signal_eilseq)
-                        po_gram_error (_("\
-incomplete multibyte sequence at end of line"));
-                      bytes = mbf->bufcount - 1;
+                        po_gram_error (_("invalid multibyte sequence"));
                       mbc->uc_valid = false;
                       break;
                     }
+                  mbc->uc_valid = true;
+                  break;
                 }
-              else
-                {
-                  const char *errno_description = strerror (errno);
-                  po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
-                             xasprintf ("%s: %s",
-                                        _("iconv failure"),
-                                        errno_description));
-                }
+              /* No character has been produced.  Must be an error.  */
+              if (res != (size_t)(-1))
+                abort ();
             }
-          else
+
+          if (errno == EILSEQ)
+            {
+              /* An invalid multibyte sequence was encountered.  */
+              /* Return a single byte.  */
+              if (signal_eilseq)
+                po_gram_error (_("invalid multibyte sequence"));
+              bytes = 1;
+              mbc->uc_valid = false;
+              break;
+            }
+          else if (errno == EINVAL)
             {
-              size_t outbytes = sizeof (scratchbuf) - outsize;
-              bytes = mbf->bufcount - insize;
+              /* An incomplete multibyte character.  */
+              int c;
 
-              /* We expect that one character has been produced.  */
-              if (bytes == 0)
-                abort ();
-              if (outbytes == 0)
-                abort ();
-              /* Convert it from UTF-8 to UCS-4.  */
-              if (u8_mbtoucr (&mbc->uc, scratchbuf, outbytes) < (int) outbytes)
+              if (mbf->bufcount == MBCHAR_BUF_SIZE)
                 {
-                  /* scratchbuf contains an out-of-range Unicode character
-                     (> 0x10ffff).  */
+                  /* An overlong incomplete multibyte sequence was
+                     encountered.  */
+                  /* Return a single byte.  */
+                  bytes = 1;
+                  mbc->uc_valid = false;
+                  break;
+                }
+
+              /* Read one more byte and retry.  */
+              c = getc (mbf->fp);
+              if (c == EOF)
+                {
+                  mbf->eof_seen = true;
+                  if (ferror (mbf->fp))
+                    goto eof;
                   if (signal_eilseq)
-                    po_gram_error (_("invalid multibyte sequence"));
+                    po_gram_error (_("\
+incomplete multibyte sequence at end of file"));
+                  bytes = mbf->bufcount;
                   mbc->uc_valid = false;
                   break;
                 }
-              mbc->uc_valid = true;
-              break;
+              mbf->buf[mbf->bufcount++] = (unsigned char) c;
+              if (c == '\n')
+                {
+                  if (signal_eilseq)
+                    po_gram_error (_("\
+incomplete multibyte sequence at end of line"));
+                  bytes = mbf->bufcount - 1;
+                  mbc->uc_valid = false;
+                  break;
+                }
+            }
+          else
+            {
+              const char *errno_description = strerror (errno);
+              po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+                         xasprintf ("%s: %s",
+                                    _("iconv failure"),
+                                    errno_description));
             }
         }
     }
@@ -601,6 +643,7 @@ unsigned int gram_max_allowed_errors = 20;
 static bool po_lex_obsolete;
 static bool po_lex_previous;
 static bool pass_comments = false;
+static bool pass_only_special_comments = false;
 bool pass_obsolete_entries = false;
 
 
@@ -715,6 +758,46 @@ lex_ungetc (const mbchar_t mbc)
 }
 
 
+/* Fast path for the bulk of a PO file: read a run of printable ASCII
+   characters, other than '\\' and STOP, directly from the stream, bypassing
+   mbfile_getc.  Each such byte is a character of width 1 on its own, and
+   cannot start a backslash-newline.  If BUFP is not NULL, the characters are
+   appended to *BUFP at BUFPOS, growing *BUFP and *BUFMAXP as needed.
+   Return the new BUFPOS.  */
+static size_t
+lex_ascii_run (char **bufp, size_t *bufmaxp, size_t bufpos, char stop)
+{
+  FILE *fp = mbf->fp;
+  int c;
+
+  if (mbf->eof_seen || mbf->have_pushback > 0 || mbf->bufcount > 0
+      || !lex_ascii_compatible ())
+    return bufpos;
+
+  for (;;)
+    {
+      c = getc (fp);
+      if (!(c >= 0x20 && c <= 0x7E && c != '\\' && c != stop))
+        break;
+      if (bufp != NULL)
+        {
+          if (bufpos + 1 >= *bufmaxp)
+            {
+              *bufmaxp = 2 * *bufmaxp + 100;
+              *bufp = xrealloc (*bufp, *bufmaxp);
+            }
+          (*bufp)[bufpos++] = c;
+        }
+      gram_pos_column++;
+    }
+  if (c != EOF)
+    ungetc (c, fp);
+  else
+    mbf->eof_seen = true;
+  return bufpos;
+}
+
+
 static int
 keyword_p (const char *s)
 {
@@ -925,7 +1008,9 @@ po_gram_lex ()
                to pass comments, generate a COMMENT token, otherwise
                discard it.  */
             signal_eilseq = false;
-            if (pass_comments)
+            if (pass_comments
+                && (!pass_only_special_comments
+                    || mb_iseq (mbc, ',') || mb_iseq (mbc, '!')))
               {
                 bufpos = 0;
                 for (;;)
@@ -941,6 +1026,7 @@ po_gram_lex ()
                     memcpy_small (&buf[bufpos], mb_ptr (mbc), mb_len (mbc));
                     bufpos += mb_len (mbc);
 
+                    bufpos = lex_ascii_run (&buf, &bufmax, bufpos, '\0');
                     lex_getc (mbc);
                   }
                 buf[bufpos] = '\0';
@@ -958,7 +1044,10 @@ po_gram_lex ()
                    comments while they get not passed to the upper layers
                    is not very efficient.  */
                 while (!mb_iseof (mbc) && !mb_iseq (mbc, '\n'))
-                  lex_getc (mbc);
+                  {
+                    lex_ascii_run (NULL, NULL, 0, '\0');
+                    lex_getc (mbc);
+                  }
                 po_lex_obsolete = false;
                 signal_eilseq = true;
               }
@@ -969,6 +1058,7 @@ po_gram_lex ()
             bufpos = 0;
             for (;;)
               {
+                bufpos = lex_ascii_run (&buf, &bufmax, bufpos, '"');
                 lex_getc (mbc);
                 while (bufpos + mb_len (mbc) >= bufmax)
                   {
@@ -1142,6 +1232,16 @@ po_lex_pass_comments (bool flag)
 }
 
 
+/* When po_gram_lex() returns comments, it can restrict them to the special
+   comments, which carry the flags of a message, and discard the others.
+   Switch this on or off.  */
+void
+po_lex_pass_only_special_comments (bool flag)
+{
+  pass_only_special_comments = flag;
+}
+
+
 /* po_gram_lex() can return obsolete entries as if they were normal entries.
    Switch this on or off.  */
 void
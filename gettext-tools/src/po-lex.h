@@ -78,6 +78,11 @@ extern int po_gram_lex (void);
 /* po_gram_lex() can return comments as COMMENT.  Switch this on or off.  */
 extern void po_lex_pass_comments (bool flag);
 
+/* When po_gram_lex() returns comments, it can restrict them to the special
+   comments, which carry the flags of a message, and discard the others.
+   Switch this on or off.  */
+extern void po_lex_pass_only_special_comments (bool flag);
+
 /* po_gram_lex() can return obsolete entries as if they were normal entries.
    Switch this on or off.  */
 extern void po_lex_pass_obsolete_entries (bool flag);
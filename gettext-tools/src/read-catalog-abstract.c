@@ -167,10 +167,11 @@ parse_end (abstract_catalog_reader_ty *pop)
 }
 
 
-void
-catalog_reader_parse (abstract_catalog_reader_ty *pop, FILE *fp,
-                      const char *real_filename, const char *logical_filename,
-                      catalog_input_format_ty input_syntax)
+int
+catalog_reader_parse_nonfatal (abstract_catalog_reader_ty *pop, FILE *fp,
+                               const char *real_filename,
+                               const char *logical_filename,
+                               catalog_input_format_ty input_syntax)
 {
   error_message_count = 0;
 
@@ -179,6 +180,18 @@ catalog_reader_parse (abstract_catalog_reader_ty *pop, FILE *fp,
   input_syntax->parse (pop, fp, real_filename, logical_filename);
   parse_end (pop);
 
+  return error_message_count;
+}
+
+
+void
+catalog_reader_parse (abstract_catalog_reader_ty *pop, FILE *fp,
+                      const char *real_filename, const char *logical_filename,
+                      catalog_input_format_ty input_syntax)
+{
+  catalog_reader_parse_nonfatal (pop, fp, real_filename, logical_filename,
+                                 input_syntax);
+
   if (error_message_count > 0)
     po_xerror (PO_SEVERITY_FATAL_ERROR, NULL,
                /*real_filename*/ NULL, (size_t)(-1), (size_t)(-1), false,
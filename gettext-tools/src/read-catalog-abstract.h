@@ -157,6 +157,15 @@ extern void
                              const char *logical_filename,
                              catalog_input_format_ty input_syntax);
 
+/* Like catalog_reader_parse, except that errors in the file are not fatal.
+   Return the number of errors.  */
+extern int
+       catalog_reader_parse_nonfatal (abstract_catalog_reader_ty *pop,
+                                      FILE *fp,
+                                      const char *real_filename,
+                                      const char *logical_filename,
+                                      catalog_input_format_ty input_syntax);
+
 /* Call the destructor and deallocate a abstract_catalog_reader_ty (or derived
    class) instance.  */
 extern void
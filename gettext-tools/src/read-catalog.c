@@ -24,13 +24,19 @@
 #include "read-catalog.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "open-catalog.h"
+#include "catalog-cache.h"
+#include "read-po.h"
 #include "po-charset.h"
 #include "po-xerror.h"
+#include "error.h"
+#include "hash.h"
 #include "xalloc.h"
+#include "xmalloca.h"
 #include "gettext.h"
 
 #define _(str) gettext (str)
@@ -95,6 +101,9 @@ default_constructor (abstract_catalog_reader_ty *that)
   default_catalog_reader_ty *this = (default_catalog_reader_ty *) that;
   size_t i;
 
+  /* File positions are kept unless the subclass or caller decides
+     otherwise.  */
+  this->handle_filepos_comments = true;
   this->domain = MESSAGE_DOMAIN_DEFAULT;
   this->comment = NULL;
   this->comment_dot = NULL;
@@ -136,9 +145,14 @@ default_destructor (abstract_catalog_reader_ty *that)
 void
 default_parse_brief (abstract_catalog_reader_ty *that)
 {
+  default_catalog_reader_ty *this = (default_catalog_reader_ty *) that;
+
   /* We need to parse comments, because even if this->handle_comments
-     is false, we need to know which messages are fuzzy.  */
+     is false, we need to know which messages are fuzzy.  But the other
+     comments can then be skipped by the lexer already.  */
   po_lex_pass_comments (true);
+  po_lex_pass_only_special_comments (!this->handle_comments
+                                     && !this->handle_filepos_comments);
 }
 
 
@@ -291,6 +305,9 @@ default_comment_filepos (abstract_catalog_reader_ty *that,
   size_t nbytes;
   lex_pos_ty *pp;
 
+  if (!this->handle_filepos_comments)
+    return;
+
   nbytes = (this->filepos_count + 1) * sizeof (this->filepos[0]);
   this->filepos = xrealloc (this->filepos, nbytes);
   pp = &this->filepos[this->filepos_count++];
@@ -456,6 +473,10 @@ default_catalog_reader_alloc (default_catalog_reader_class_ty *method_table)
    appropriately.  Defaults to false.  */
 bool allow_duplicates = false;
 
+/* If true, the comments and file positions of the messages are not read,
+   only their flags.  Defaults to false.  */
+bool discard_comments = false;
+
 
 msgdomain_list_ty *
 read_catalog_stream (FILE *fp, const char *real_filename,
@@ -466,7 +487,8 @@ read_catalog_stream (FILE *fp, const char *real_filename,
   msgdomain_list_ty *mdlp;
 
   pop = default_catalog_reader_alloc (&default_methods);
-  pop->handle_comments = true;
+  pop->handle_comments = !discard_comments;
+  pop->handle_filepos_comments = !discard_comments;
   pop->allow_domain_directives = true;
   pop->allow_duplicates = allow_duplicates;
   pop->allow_duplicates_if_same_msgstr = false;
@@ -485,17 +507,240 @@ read_catalog_stream (FILE *fp, const char *real_filename,
 }
 
 
+/* Diagnostics seen while reading a file.  A file whose reading produces
+   diagnostics is not cached, so that they are reported each time.  */
+static unsigned int diagnostic_count;
+static void (*saved_xerror) (int severity,
+                             const struct message_ty *message,
+                             const char *filename,
+                             size_t lineno, size_t column,
+                             int multiline_p, const char *message_text);
+
+static void
+counting_xerror (int severity,
+                 const struct message_ty *message,
+                 const char *filename, size_t lineno, size_t column,
+                 int multiline_p, const char *message_text)
+{
+  diagnostic_count++;
+  saved_xerror (severity, message, filename, lineno, column,
+                multiline_p, message_text);
+}
+
 msgdomain_list_ty *
 read_catalog_file (const char *filename, catalog_input_format_ty input_syntax)
 {
   char *real_filename;
   FILE *fp = open_catalog_file (filename, &real_filename, true);
+  bool use_cache;
   msgdomain_list_ty *result;
 
-  result = read_catalog_stream (fp, real_filename, filename, input_syntax);
+  /* Only PO files are cached, not the other input formats.  */
+  use_cache = (input_syntax == &input_format_po && fp != stdin
+               && catalog_cache_enabled ());
+
+  result = NULL;
+  if (use_cache)
+    result = catalog_cache_read (fp, real_filename, allow_duplicates);
+  if (result == NULL)
+    {
+      if (use_cache)
+        {
+          diagnostic_count = 0;
+          saved_xerror = po_xerror;
+          po_xerror = counting_xerror;
+        }
+      result = read_catalog_stream (fp, real_filename, filename, input_syntax);
+      if (use_cache)
+        {
+          po_xerror = saved_xerror;
+          /* A result without comments must not be cached, because it
+             would be wrong for the programs that need them.  */
+          if (diagnostic_count == 0 && error_message_count == 0
+              && !discard_comments)
+            catalog_cache_write (result, fp, real_filename, allow_duplicates);
+        }
+    }
 
   if (fp != stdin)
     fclose (fp);
 
   return result;
 }
+
+
+/* ========================================================================= */
+/* Reading a catalog one message at a time.  */
+
+
+/* A derived class of default_catalog_reader_ty that passes the messages to a
+   callback instead of collecting them in this->mdlp.  */
+
+typedef struct streaming_catalog_reader_ty streaming_catalog_reader_ty;
+struct streaming_catalog_reader_ty
+{
+  DEFAULT_CATALOG_READER_TY
+
+  /* Where to pass the messages.  */
+  catalog_message_handler_ty handler;
+  void *handler_data;
+
+  /* The keys (domain, msgctxt, msgid) of the messages seen so far, mapped
+     to the line number of their definition.  */
+  hash_table keys;
+};
+
+
+static void
+streaming_add_message (default_catalog_reader_ty *that,
+                       char *msgctxt,
+                       char *msgid,
+                       lex_pos_ty *msgid_pos,
+                       char *msgid_plural,
+                       char *msgstr, size_t msgstr_len,
+                       lex_pos_ty *msgstr_pos,
+                       char *prev_msgctxt,
+                       char *prev_msgid,
+                       char *prev_msgid_plural,
+                       bool force_fuzzy, bool obsolete)
+{
+  streaming_catalog_reader_ty *this = (streaming_catalog_reader_ty *) that;
+  message_ty *mp;
+
+  if (!(this->allow_duplicates && msgid[0] != '\0'))
+    {
+      /* See if this message ID has been seen before.  The key is the domain,
+         followed by a NUL byte, followed by the same concatenation of msgctxt
+         and msgid as in a message list's hash table.  */
+      size_t domain_len = strlen (this->domain);
+      size_t msgctxt_len = (msgctxt != NULL ? strlen (msgctxt) : 0);
+      size_t msgid_len = strlen (msgid);
+      size_t keylen =
+        domain_len + 1
+        + (msgctxt != NULL ? msgctxt_len + 1 : 0)
+        + msgid_len + 1;
+      char *key = (char *) xmalloca (keylen);
+      char *p = key;
+      bool duplicate;
+
+      memcpy (p, this->domain, domain_len + 1);
+      p += domain_len + 1;
+      if (msgctxt != NULL)
+        {
+          memcpy (p, msgctxt, msgctxt_len);
+          p += msgctxt_len;
+          *p++ = MSGCTXT_SEPARATOR;
+        }
+      memcpy (p, msgid, msgid_len + 1);
+
+      duplicate =
+        (hash_insert_entry (&this->keys, key, keylen,
+                            (void *) (uintptr_t) msgstr_pos->line_number)
+         == NULL);
+      if (duplicate)
+        {
+          void *first_line;
+
+          hash_find_entry (&this->keys, key, keylen, &first_line);
+          po_xerror2 (PO_SEVERITY_ERROR,
+                      NULL, msgid_pos->file_name, msgid_pos->line_number,
+                      (size_t)(-1), false, _("duplicate message definition"),
+                      NULL, msgid_pos->file_name,
+                      (size_t) (uintptr_t) first_line, (size_t)(-1), false,
+                      _("this is the location of the first definition"));
+        }
+      freea (key);
+
+      if (duplicate)
+        {
+          free (msgid);
+          if (msgid_plural != NULL)
+            free (msgid_plural);
+          free (msgstr);
+          if (msgctxt != NULL)
+            free (msgctxt);
+          if (prev_msgctxt != NULL)
+            free (prev_msgctxt);
+          if (prev_msgid != NULL)
+            free (prev_msgid);
+          if (prev_msgid_plural != NULL)
+            free (prev_msgid_plural);
+          return;
+        }
+    }
+
+  mp = message_alloc (msgctxt, msgid, msgid_plural, msgstr, msgstr_len,
+                      msgstr_pos);
+  mp->prev_msgctxt = prev_msgctxt;
+  mp->prev_msgid = prev_msgid;
+  mp->prev_msgid_plural = prev_msgid_plural;
+  mp->obsolete = obsolete;
+  default_copy_comment_state (that, mp);
+  if (force_fuzzy)
+    mp->is_fuzzy = true;
+
+  call_frob_new_message (that, mp, msgid_pos, msgstr_pos);
+
+  /* Errors that the handler reports, e.g. while writing the message, are
+     not syntax errors in the input and must not make the parse fail.  */
+  {
+    unsigned int saved_error_message_count = error_message_count;
+
+    this->handler (this->domain, mp, this->handler_data);
+    error_message_count = saved_error_message_count;
+  }
+}
+
+
+static default_catalog_reader_class_ty streaming_methods =
+{
+  {
+    sizeof (streaming_catalog_reader_ty),
+    default_constructor,
+    default_destructor,
+    default_parse_brief,
+    default_parse_debrief,
+    default_directive_domain,
+    default_directive_message,
+    default_comment,
+    default_comment_dot,
+    default_comment_filepos,
+    default_comment_special
+  },
+  default_set_domain, /* set_domain */
+  streaming_add_message, /* add_message */
+  NULL /* frob_new_message */
+};
+
+
+void
+read_catalog_file_streaming (const char *filename,
+                             catalog_input_format_ty input_syntax,
+                             catalog_message_handler_ty handler, void *data)
+{
+  char *real_filename;
+  FILE *fp = open_catalog_file (filename, &real_filename, true);
+  streaming_catalog_reader_ty *pop;
+
+  pop = (streaming_catalog_reader_ty *)
+    default_catalog_reader_alloc (&streaming_methods);
+  pop->handle_comments = true;
+  pop->handle_filepos_comments = true;
+  pop->allow_domain_directives = true;
+  pop->allow_duplicates = allow_duplicates;
+  pop->allow_duplicates_if_same_msgstr = false;
+  pop->file_name = real_filename;
+  pop->mdlp = NULL;
+  pop->mlp = NULL;
+  pop->handler = handler;
+  pop->handler_data = data;
+  hash_init (&pop->keys, 1000);
+  po_lex_pass_obsolete_entries (true);
+  catalog_reader_parse ((abstract_catalog_reader_ty *) pop, fp, real_filename,
+                        filename, input_syntax);
+  hash_destroy (&pop->keys);
+  catalog_reader_free ((abstract_catalog_reader_ty *) pop);
+
+  if (fp != stdin)
+    fclose (fp);
+}
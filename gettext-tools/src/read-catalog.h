@@ -75,9 +75,12 @@ struct default_catalog_reader_class_ty
 #define DEFAULT_CATALOG_READER_TY \
   ABSTRACT_CATALOG_READER_TY                                            \
                                                                         \
-  /* If true, pay attention to comments and filepos comments.  */       \
+  /* If true, pay attention to comments.  */                           \
   bool handle_comments;                                                 \
                                                                         \
+  /* If true, pay attention to filepos comments.  */                    \
+  bool handle_filepos_comments;                                         \
+                                                                        \
   /* If false, domain directives lead to an error messsage.  */         \
   bool allow_domain_directives;                                         \
                                                                         \
@@ -170,6 +173,11 @@ extern default_catalog_reader_ty *
    appropriately.  Defaults to false.  */
 extern DLL_VARIABLE bool allow_duplicates;
 
+/* If true, the comments and file positions of the messages are not read,
+   only their flags.  This makes reading faster for programs that don't
+   need them.  Defaults to false.  */
+extern DLL_VARIABLE bool discard_comments;
+
 /* Read the input file from a stream.  Returns a list of messages.  */
 extern msgdomain_list_ty *
        read_catalog_stream (FILE *fp,
@@ -185,6 +193,21 @@ extern msgdomain_list_ty *
        read_catalog_file (const char *input_name,
                           catalog_input_format_ty input_syntax);
 
+/* Callback that receives the messages of a catalog one at a time.  DOMAIN
+   is the domain of the message MP.  The callback takes ownership of MP.  */
+typedef void (*catalog_message_handler_ty) (const char *domain,
+                                            message_ty *mp, void *data);
+
+/* Read the input file with the name INPUT_NAME, like read_catalog_file,
+   but instead of collecting the messages in a list, pass each of them to
+   HANDLER as soon as it has been read, together with DATA.  Only the keys
+   of the messages are kept, for the detection of duplicates.  */
+extern void
+       read_catalog_file_streaming (const char *input_name,
+                                    catalog_input_format_ty input_syntax,
+                                    catalog_message_handler_ty handler,
+                                    void *data);
+
 
 #ifdef __cplusplus
 }
@@ -28,9 +28,18 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined HAVE_MMAP && defined HAVE_MUNMAP
+# include <sys/mman.h>
+#else
+# undef HAVE_MMAP
+#endif
 
 /* This include file describes the main part of binary .mo format.  */
 #include "gmo.h"
+#include "lz-block.h"
 
 #include "error.h"
 #include "xalloc.h"
@@ -49,8 +58,10 @@ enum mo_endianness
   MO_BIG_ENDIAN
 };
 
-/* We read the file completely into memory.  This is more efficient than
-   lots of lseek().  This struct represents the .mo file in memory.  */
+/* We read the file completely into memory, or map it when possible.  This
+   is more efficient than lots of lseek().  This struct represents the .mo
+   file in memory.  The memory is never released: the strings of the
+   messages point into it.  */
 struct binary_mo_file
 {
   const char *filename;
@@ -69,18 +80,47 @@ read_binary_mo_file (struct binary_mo_file *bfp,
   size_t alloc = 0;
   size_t size = 0;
   size_t count;
+  struct stat statbuf;
+
+  bfp->filename = filename;
+
+  /* When reading a regular file, its size is known in advance.  */
+  if (fp != stdin
+      && fstat (fileno (fp), &statbuf) >= 0
+      && S_ISREG (statbuf.st_mode)
+      && statbuf.st_size > 0
+      && (size_t) statbuf.st_size == statbuf.st_size)
+    {
+#ifdef HAVE_MMAP
+      /* Map the file.  The mapping is private, so that the few places
+         that store a NUL byte into a string don't modify the file.  */
+      buf = (char *) mmap (NULL, statbuf.st_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE, fileno (fp), 0);
+      if (buf != (char *) MAP_FAILED)
+        {
+          bfp->data = buf;
+          bfp->size = statbuf.st_size;
+          return;
+        }
+      buf = NULL;
+#endif
+      /* Read the file in a single fread call.  The additional byte lets
+         fread notice the end of the file.  */
+      alloc = xsum (statbuf.st_size, 1);
+      buf = (char *) xmalloc (alloc);
+    }
 
   while (!feof (fp))
     {
       const size_t increment = 4096;
-      if (size + increment > alloc)
+      if (size == alloc)
         {
           alloc = alloc + alloc / 2;
           if (alloc < size + increment)
             alloc = size + increment;
           buf = (char *) xrealloc (buf, alloc);
         }
-      count = fread (buf + size, 1, increment, fp);
+      count = fread (buf + size, 1, alloc - size, fp);
       if (count == 0)
         {
           if (ferror (fp))
@@ -91,7 +131,6 @@ read_binary_mo_file (struct binary_mo_file *bfp,
         size += count;
     }
   buf = (char *) xrealloc (buf, size);
-  bfp->filename = filename;
   bfp->data = buf;
   bfp->size = size;
 }
@@ -116,24 +155,93 @@ get_uint32 (const struct binary_mo_file *bfp, size_t offset)
     return (b0 << 24) | (b1 << 16) | (b2 << 8) | b3;
 }
 
-/* Get a static string from the file, at the given file position.  */
+/* Get a static string, whose descriptor is in the file at the given file
+   position.  The string itself is in STRINGS, which is either the file or
+   the uncompressed contents of its compressed blocks.  */
 static char *
-get_string (const struct binary_mo_file *bfp, size_t offset, size_t *lengthp)
+get_string (const struct binary_mo_file *bfp, size_t offset,
+            const struct binary_mo_file *strings, size_t *lengthp)
 {
   /* See 'struct string_desc'.  */
   nls_uint32 s_length = get_uint32 (bfp, offset);
   nls_uint32 s_offset = get_uint32 (bfp, offset + 4);
   size_t s_end = xsum3 (s_offset, s_length, 1);
 
-  if (size_overflow_p (s_end) || s_end > bfp->size)
+  if (size_overflow_p (s_end) || s_end > strings->size)
     error (EXIT_FAILURE, 0, _("file \"%s\" is truncated"), bfp->filename);
-  if (bfp->data[s_offset + s_length] != '\0')
+  if (strings->data[s_offset + s_length] != '\0')
     error (EXIT_FAILURE, 0,
            _("file \"%s\" contains a not NUL terminated string"),
            bfp->filename);
 
   *lengthp = s_length + 1;
-  return bfp->data + s_offset;
+  return strings->data + s_offset;
+}
+
+/* Uncompress the compressed blocks of a .mo file with major revision 2
+   into CONTENTS.  See 'struct mo_file_compression'.  */
+static void
+read_compressed_blocks (const struct binary_mo_file *bfp,
+                        struct binary_mo_file *contents)
+{
+  size_t compression_offset = sizeof (struct mo_file_header);
+  nls_uint32 n_blocks =
+    get_uint32 (bfp, compression_offset
+                     + offsetof (struct mo_file_compression, n_blocks));
+  nls_uint32 blocks_offset =
+    get_uint32 (bfp, compression_offset
+                     + offsetof (struct mo_file_compression, blocks_offset));
+  size_t size;
+  nls_uint32 i;
+
+  /* See 'struct compressed_block'.  The blocks are sorted by start and
+     don't overlap; between them there may be alignment padding.  Validate
+     all blocks before allocating, so that the allocated size is bounded
+     by the file size: a block cannot expand by more than
+     LZ_BLOCK_MAX_RATIO.  */
+  if (blocks_offset > bfp->size || (bfp->size - blocks_offset) / 16 < n_blocks)
+    error (EXIT_FAILURE, 0, _("file \"%s\" is truncated"), bfp->filename);
+  size = 0;
+  for (i = 0; i < n_blocks; i++)
+    {
+      size_t block_offset = blocks_offset + (size_t) i * 16;
+      nls_uint32 length = get_uint32 (bfp, block_offset);
+      nls_uint32 offset = get_uint32 (bfp, block_offset + 4);
+      nls_uint32 start = get_uint32 (bfp, block_offset + 8);
+      nls_uint32 block_size = get_uint32 (bfp, block_offset + 12);
+      size_t end = xsum (offset, length);
+
+      if (size_overflow_p (end) || end > bfp->size)
+        error (EXIT_FAILURE, 0, _("file \"%s\" is truncated"), bfp->filename);
+      if (start < size || block_size / LZ_BLOCK_MAX_RATIO > length)
+        error (EXIT_FAILURE, 0, _("file \"%s\" is not in GNU .mo format"),
+               bfp->filename);
+      size = xsum (start, block_size);
+    }
+  if (size_overflow_p (size) || size / LZ_BLOCK_MAX_RATIO > bfp->size)
+    error (EXIT_FAILURE, 0, _("file \"%s\" is not in GNU .mo format"),
+           bfp->filename);
+
+  contents->filename = bfp->filename;
+  contents->data = XNMALLOC (size, char);
+  memset (contents->data, '\0', size);
+  contents->size = size;
+  contents->endian = bfp->endian;
+
+  for (i = 0; i < n_blocks; i++)
+    {
+      size_t block_offset = blocks_offset + (size_t) i * 16;
+      nls_uint32 length = get_uint32 (bfp, block_offset);
+      nls_uint32 offset = get_uint32 (bfp, block_offset + 4);
+      nls_uint32 start = get_uint32 (bfp, block_offset + 8);
+      nls_uint32 block_size = get_uint32 (bfp, block_offset + 12);
+
+      if (lz_block_decode (bfp->data + offset, length,
+                           contents->data + start, block_size) < 0)
+        error (EXIT_FAILURE, 0,
+               _("file \"%s\" contains a damaged compressed block"),
+               bfp->filename);
+    }
 }
 
 /* Get a system dependent string from the file, at the given file position.  */
@@ -244,7 +352,10 @@ read_mo_file (message_list_ty *mlp, const char *filename)
 {
   FILE *fp;
   struct binary_mo_file bf;
+  struct binary_mo_file contents;
+  const struct binary_mo_file *strings;
   struct mo_file_header header;
+  message_ty *messages;
   unsigned int i;
   static lex_pos_ty pos = { __FILE__, __LINE__ };
 
@@ -287,21 +398,41 @@ read_mo_file (message_list_ty *mlp, const char *filename)
 
   header.revision = GET_HEADER_FIELD (revision);
 
-  /* We support only the major revisions 0 and 1.  */
+  /* We support only the major revisions 0, 1 and 2.  */
   switch (header.revision >> 16)
     {
     case 0:
     case 1:
-      /* Fill the header parts that apply to major revisions 0 and 1.  */
+    case 2:
+      /* Fill the header parts that apply to major revisions 0, 1 and 2.  */
       header.nstrings = GET_HEADER_FIELD (nstrings);
       header.orig_tab_offset = GET_HEADER_FIELD (orig_tab_offset);
       header.trans_tab_offset = GET_HEADER_FIELD (trans_tab_offset);
       header.hash_tab_size = GET_HEADER_FIELD (hash_tab_size);
       header.hash_tab_offset = GET_HEADER_FIELD (hash_tab_offset);
 
+      /* Each string needs two string descriptors of 8 bytes each.  Check
+         this before allocating memory for the messages.  */
+      if (header.nstrings > bf.size / 16)
+        error (EXIT_FAILURE, 0, _("file \"%s\" is truncated"), filename);
+
+      /* In major revision 2, the translated strings are compressed.  */
+      if ((header.revision >> 16) == MO_REVISION_NUMBER_COMPRESSED)
+        {
+          read_compressed_blocks (&bf, &contents);
+          strings = &contents;
+        }
+      else
+        strings = &bf;
+
+      /* Allocate all messages in a single block.  Their strings point
+         into the file contents.  */
+      messages = XNMALLOC (header.nstrings, message_ty);
+      message_list_reserve (mlp, header.nstrings);
+
       for (i = 0; i < header.nstrings; i++)
         {
-          message_ty *mp;
+          message_ty *mp = &messages[i];
           char *msgctxt;
           char *msgid;
           size_t msgid_len;
@@ -310,7 +441,7 @@ read_mo_file (message_list_ty *mlp, const char *filename)
           size_t msgstr_len;
 
           /* Read the msgctxt and msgid.  */
-          msgid = get_string (&bf, header.orig_tab_offset + i * 8,
+          msgid = get_string (&bf, header.orig_tab_offset + i * 8, &bf,
                               &msgid_len);
           /* Split into msgctxt and msgid.  */
           separator = strchr (msgid, MSGCTXT_SEPARATOR);
@@ -326,16 +457,17 @@ read_mo_file (message_list_ty *mlp, const char *filename)
             msgctxt = NULL;
 
           /* Read the msgstr.  */
-          msgstr = get_string (&bf, header.trans_tab_offset + i * 8,
+          msgstr = get_string (&bf, header.trans_tab_offset + i * 8, strings,
                                &msgstr_len);
 
-          mp = message_alloc (msgctxt,
-                              msgid,
-                              (strlen (msgid) + 1 < msgid_len
-                               ? msgid + strlen (msgid) + 1
-                               : NULL),
-                              msgstr, msgstr_len,
-                              &pos);
+          message_init (mp,
+                        msgctxt,
+                        msgid,
+                        (strlen (msgid) + 1 < msgid_len
+                         ? msgid + strlen (msgid) + 1
+                         : NULL),
+                        msgstr, msgstr_len,
+                        &pos);
           message_list_append (mlp, mp);
         }
 
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include <unistd.h>
 #ifndef STDOUT_FILENO
@@ -36,8 +37,11 @@
 
 #include "ostream.h"
 #include "file-ostream.h"
+#include "memory-ostream.h"
 #include "fwriteerror.h"
 #include "error-progname.h"
+#include "write-po.h"
+#include "xalloc.h"
 #include "xvasprintf.h"
 #include "po-xerror.h"
 #include "gettext.h"
@@ -90,37 +94,12 @@ message_page_width_set (size_t n)
 /* ======================== msgdomain_list_print() ======================== */
 
 
-void
-msgdomain_list_print (msgdomain_list_ty *mdlp, const char *filename,
-                      catalog_output_format_ty output_syntax,
-                      bool force, bool debug)
+/* Check whether the output format can accommodate all messages.  Report
+   a fatal error if not.  */
+static void
+check_output_syntax (msgdomain_list_ty *mdlp,
+                     catalog_output_format_ty output_syntax)
 {
-  bool to_stdout;
-
-  /* We will not write anything if, for every domain, we have no message
-     or only the header entry.  */
-  if (!force)
-    {
-      bool found_nonempty = false;
-      size_t k;
-
-      for (k = 0; k < mdlp->nitems; k++)
-        {
-          message_list_ty *mlp = mdlp->item[k]->messages;
-
-          if (!(mlp->nitems == 0
-                || (mlp->nitems == 1 && is_header (mlp->item[0]))))
-            {
-              found_nonempty = true;
-              break;
-            }
-        }
-
-      if (!found_nonempty)
-        return;
-    }
-
-  /* Check whether the output format can accommodate all messages.  */
   if (!output_syntax->supports_multiple_domains && mdlp->nitems > 1)
     {
       if (output_syntax->alternative_is_po)
@@ -206,6 +185,41 @@ message catalog has plural form translations, but the output format does not sup
             }
         }
     }
+}
+
+
+void
+msgdomain_list_print (msgdomain_list_ty *mdlp, const char *filename,
+                      catalog_output_format_ty output_syntax,
+                      bool force, bool debug)
+{
+  bool to_stdout;
+
+  /* We will not write anything if, for every domain, we have no message
+     or only the header entry.  */
+  if (!force)
+    {
+      bool found_nonempty = false;
+      size_t k;
+
+      for (k = 0; k < mdlp->nitems; k++)
+        {
+          message_list_ty *mlp = mdlp->item[k]->messages;
+
+          if (!(mlp->nitems == 0
+                || (mlp->nitems == 1 && is_header (mlp->item[0]))))
+            {
+              found_nonempty = true;
+              break;
+            }
+        }
+
+      if (!found_nonempty)
+        return;
+    }
+
+  /* Check whether the output format can accommodate all messages.  */
+  check_output_syntax (mdlp, output_syntax);
 
   to_stdout = (filename == NULL || strcmp (filename, "-") == 0
                || strcmp (filename, "/dev/stdout") == 0);
@@ -325,6 +339,317 @@ message catalog has plural form translations, but the output format does not sup
 }
 
 
+bool
+msgdomain_list_print_if_changed (msgdomain_list_ty *mdlp, const char *filename,
+                                 catalog_output_format_ty output_syntax,
+                                 bool debug,
+                                 void (*before_replace) (const char *filename))
+{
+  struct stat statbuf;
+  FILE *fp;
+  memory_ostream_t stream;
+  const void *contents;
+  size_t contents_length;
+  const char *p;
+  size_t remaining;
+  char *temp_filename;
+  FILE *temp_fp;
+  bool unchanged;
+
+  /* Styled output is written directly, and so are files that are not
+     regular files, such as symbolic links.  */
+  if (
+#if ENABLE_COLOR
+      (output_syntax->supports_color
+       && (color_mode == color_yes || color_mode == color_html))
+      ||
+#endif
+      lstat (filename, &statbuf) < 0 || !S_ISREG (statbuf.st_mode))
+    {
+      if (before_replace != NULL)
+        before_replace (filename);
+      msgdomain_list_print (mdlp, filename, output_syntax, true, debug);
+      return true;
+    }
+
+  check_output_syntax (mdlp, output_syntax);
+
+  stream = memory_ostream_create ();
+  output_syntax->print (mdlp, stream, page_width, debug);
+  memory_ostream_contents (stream, &contents, &contents_length);
+
+  /* Write the output under a temporary name in the same directory, so that
+     FILENAME has either the old or the new contents at any time.  */
+  temp_filename = xasprintf ("%s.%ld.tmp", filename, (long) getpid ());
+  temp_fp = fopen (temp_filename, "wb");
+  if (temp_fp == NULL)
+    {
+      const char *errno_description = strerror (errno);
+      po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+                 xasprintf ("%s: %s",
+                            xasprintf (_("cannot create output file \"%s\""),
+                                       temp_filename),
+                            errno_description));
+    }
+
+  /* While writing, compare the output with the file's contents, block by
+     block.  */
+  fp = fopen (filename, "rb");
+  unchanged = (fp != NULL);
+  p = (const char *) contents;
+  remaining = contents_length;
+  while (remaining > 0)
+    {
+      char buf[4096];
+      size_t n = (remaining < sizeof (buf) ? remaining : sizeof (buf));
+
+      fwrite (p, 1, n, temp_fp);
+      if (unchanged
+          && (fread (buf, 1, n, fp) != n || memcmp (buf, p, n) != 0))
+        unchanged = false;
+      p += n;
+      remaining -= n;
+    }
+  if (fp != NULL)
+    {
+      if (unchanged && (getc (fp) != EOF || ferror (fp)))
+        unchanged = false;
+      fclose (fp);
+    }
+  ostream_free (stream);
+
+  if (fwriteerror (temp_fp))
+    {
+      const char *errno_description = strerror (errno);
+      unlink (temp_filename);
+      po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+                 xasprintf ("%s: %s",
+                            xasprintf (_("error while writing \"%s\" file"),
+                                       temp_filename),
+                            errno_description));
+    }
+
+  if (unchanged)
+    {
+      unlink (temp_filename);
+      free (temp_filename);
+      return false;
+    }
+
+  /* Keep the permissions of the file being replaced.  */
+  chmod (temp_filename, statbuf.st_mode & 07777);
+
+  if (before_replace != NULL)
+    before_replace (filename);
+
+  if (rename (temp_filename, filename) < 0)
+    {
+      const char *errno_description = strerror (errno);
+      unlink (temp_filename);
+      po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+                 xasprintf ("%s: %s",
+                            xasprintf (_("cannot rename \"%s\" to \"%s\""),
+                                       temp_filename, filename),
+                            errno_description));
+    }
+  free (temp_filename);
+
+  return true;
+}
+
+
+/* =================== Output one message at a time. ==================== */
+
+
+struct catalog_writer
+{
+  const char *filename;
+  bool force;
+  bool debug;
+
+  /* The output file, once it has been opened.  */
+  FILE *fp;
+  file_ostream_t stream;
+  po_writer_ty *po_writer;
+
+  /* The messages held back until it is known whether there is anything to
+     write, when !force.  These are only header entries, and NULL for the
+     domains of discarded messages.  */
+  size_t npending;
+  size_t npending_max;
+  const char **pending_domain;
+  message_ty **pending_message;
+};
+
+
+catalog_writer_ty *
+catalog_writer_create (const char *filename, bool force, bool debug)
+{
+  catalog_writer_ty *writer;
+
+#if ENABLE_COLOR
+  {
+    bool to_stdout = (filename == NULL || strcmp (filename, "-") == 0
+                      || strcmp (filename, "/dev/stdout") == 0);
+
+    /* Styled output is not supported.  */
+    if (color_mode == color_yes || color_mode == color_html
+        || (color_mode == color_tty && to_stdout && isatty (STDOUT_FILENO)))
+      return NULL;
+  }
+#endif
+
+  writer = XMALLOC (catalog_writer_ty);
+  writer->filename = filename;
+  writer->force = force;
+  writer->debug = debug;
+  writer->fp = NULL;
+  writer->stream = NULL;
+  writer->po_writer = NULL;
+  writer->npending = 0;
+  writer->npending_max = 0;
+  writer->pending_domain = NULL;
+  writer->pending_message = NULL;
+  return writer;
+}
+
+
+/* Open the output file and write the messages held back so far.  */
+static void
+catalog_writer_open (catalog_writer_ty *writer)
+{
+  const char *filename = writer->filename;
+  size_t i;
+
+  if (!(filename == NULL || strcmp (filename, "-") == 0
+        || strcmp (filename, "/dev/stdout") == 0))
+    {
+      writer->fp = fopen (filename, "wb");
+      if (writer->fp == NULL)
+        {
+          const char *errno_description = strerror (errno);
+          po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+                     xasprintf ("%s: %s",
+                                xasprintf (_("cannot create output file \"%s\""),
+                                           filename),
+                                errno_description));
+        }
+    }
+  else
+    {
+      writer->fp = stdout;
+      writer->filename = _("standard output");
+    }
+
+  writer->stream = file_ostream_create (writer->fp);
+  writer->po_writer =
+    po_writer_create (writer->stream, page_width, writer->debug);
+
+  for (i = 0; i < writer->npending; i++)
+    if (writer->pending_message[i] != NULL)
+      po_writer_message (writer->po_writer, writer->pending_domain[i],
+                         writer->pending_message[i]);
+    else
+      po_writer_domain (writer->po_writer, writer->pending_domain[i]);
+  writer->npending = 0;
+}
+
+
+/* Hold back MP, that belongs to DOMAIN, until the output file is open.  */
+static void
+catalog_writer_hold (catalog_writer_ty *writer, const char *domain,
+                     message_ty *mp)
+{
+  if (writer->npending == writer->npending_max)
+    {
+      writer->npending_max = 2 * writer->npending_max + 1;
+      writer->pending_domain =
+        (const char **)
+        xrealloc (writer->pending_domain,
+                  writer->npending_max * sizeof (const char *));
+      writer->pending_message =
+        (message_ty **)
+        xrealloc (writer->pending_message,
+                  writer->npending_max * sizeof (message_ty *));
+    }
+  writer->pending_domain[writer->npending] = domain;
+  writer->pending_message[writer->npending] = mp;
+  writer->npending++;
+}
+
+
+void
+catalog_writer_message (catalog_writer_ty *writer, const char *domain,
+                        message_ty *mp)
+{
+  if (writer->po_writer == NULL)
+    {
+      /* We will not write anything if, for every domain, we have no message
+         or only the header entry.  */
+      if (!writer->force && is_header (mp))
+        {
+          catalog_writer_hold (writer, domain, mp);
+          return;
+        }
+      catalog_writer_open (writer);
+    }
+  po_writer_message (writer->po_writer, domain, mp);
+}
+
+
+void
+catalog_writer_discard (catalog_writer_ty *writer, const char *domain,
+                        message_ty *mp)
+{
+  message_free (mp);
+
+  if (writer->po_writer == NULL)
+    {
+      /* Only the order in which the domains first occur matters.  */
+      if (!(writer->npending > 0
+            && strcmp (writer->pending_domain[writer->npending - 1], domain)
+               == 0))
+        catalog_writer_hold (writer, domain, NULL);
+    }
+  else
+    po_writer_domain (writer->po_writer, domain);
+}
+
+
+void
+catalog_writer_close (catalog_writer_ty *writer)
+{
+  size_t i;
+
+  if (writer->po_writer == NULL && writer->force)
+    catalog_writer_open (writer);
+
+  if (writer->po_writer != NULL)
+    {
+      po_writer_free (writer->po_writer);
+      ostream_free (writer->stream);
+
+      /* Make sure nothing went wrong.  */
+      if (fwriteerror (writer->fp))
+        {
+          const char *errno_description = strerror (errno);
+          po_xerror (PO_SEVERITY_FATAL_ERROR, NULL, NULL, 0, 0, false,
+                     xasprintf ("%s: %s",
+                                xasprintf (_("error while writing \"%s\" file"),
+                                           writer->filename),
+                                errno_description));
+        }
+    }
+
+  for (i = 0; i < writer->npending; i++)
+    if (writer->pending_message[i] != NULL)
+      message_free (writer->pending_message[i]);
+  free (writer->pending_domain);
+  free (writer->pending_message);
+  free (writer);
+}
+
+
 /* =============================== Sorting. ================================ */
 
 
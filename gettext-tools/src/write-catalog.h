@@ -77,6 +77,43 @@ extern void
                              catalog_output_format_ty output_syntax,
                              bool force, bool debug);
 
+/* Output MDLP into the existing file FILENAME, like msgdomain_list_print
+   with FORCE set, unless FILENAME already has exactly these contents.
+   The output is compared with the contents of FILENAME and then written
+   under a temporary name that replaces FILENAME.  BEFORE_REPLACE, if not
+   NULL, is called just before FILENAME is replaced.
+   Return true if FILENAME was replaced, false if it was left alone.  */
+extern bool
+       msgdomain_list_print_if_changed (msgdomain_list_ty *mdlp,
+                                        const char *filename,
+                                        catalog_output_format_ty output_syntax,
+                                        bool debug,
+                                        void (*before_replace) (const char *));
+
+/* Output of a PO file one message at a time, into the file FILENAME,
+   according to the parameters set by the functions above.  This allows
+   programs to write the messages of a catalog while reading it.  As with
+   msgdomain_list_print, nothing is written unless FORCE is true or there
+   is some message other than a header entry.  */
+typedef struct catalog_writer catalog_writer_ty;
+/* Return NULL if the output would be styled, which is not supported; the
+   caller then has to use msgdomain_list_print.  */
+extern catalog_writer_ty *
+       catalog_writer_create (const char *filename, bool force, bool debug);
+/* Write MP, that belongs to DOMAIN, and take ownership of it.  */
+extern void
+       catalog_writer_message (catalog_writer_ty *writer, const char *domain,
+                               message_ty *mp);
+/* Free MP, that belongs to DOMAIN, instead of writing it.  Like
+   msgdomain_list_print, the writer still writes a domain directive for
+   DOMAIN.  */
+extern void
+       catalog_writer_discard (catalog_writer_ty *writer, const char *domain,
+                               message_ty *mp);
+/* Finish the output and free WRITER.  */
+extern void
+       catalog_writer_close (catalog_writer_ty *writer);
+
 /* Sort MDLP destructively according to the given criterion.  */
 extern void
        msgdomain_list_sort_by_msgid (msgdomain_list_ty *mdlp);
@@ -28,6 +28,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if HAVE_INTTYPES_H
+# include <inttypes.h>
+#endif
 
 #if HAVE_SYS_PARAM_H
 # include <sys/param.h>
@@ -36,6 +42,7 @@
 /* These two include files describe the binary .mo format.  */
 #include "gmo.h"
 #include "hash-string.h"
+#include "lz-block.h"
 
 #include "byteswap.h"
 #include "error.h"
@@ -45,6 +52,7 @@
 #include "xsize.h"
 #include "xalloc.h"
 #include "xmalloca.h"
+#include "xvasprintf.h"
 #include "binary-io.h"
 #include "fwriteerror.h"
 #include "gettext.h"
@@ -73,10 +81,30 @@ bool byteswap;
 /* True if no hash table in .mo is wanted.  */
 bool no_hash_table;
 
+/* True if each original string shall be immediately followed by its
+   translation in .mo file.  */
+bool interleave_strings;
+
+/* True if a perfect hash table in .mo is wanted.  */
+bool perfect_hash_table;
+
+/* True if equal strings, and strings that are the end of another string,
+   shall be stored only once in .mo file.  */
+bool share_strings;
+
+/* True if the translated strings shall be compressed in .mo file.  */
+bool compress_strings;
+
+/* True if the system dependent strings shall be expanded for this platform
+   in .mo file.  */
+bool expand_sysdep_strings;
+
 
 /* Destructively changes the byte order of a 32-bit value in memory.  */
 #define BSWAP32(x) (x) = bswap_32 (x)
 
+#define SIZEOF(a) (sizeof(a) / sizeof(a[0]))
+
 
 /* Indices into the strings contained in 'struct pre_message' and
    'struct pre_sysdep_message'.  */
@@ -109,6 +137,115 @@ compare_id (const void *pval1, const void *pval2)
 }
 
 
+/* The values of the system dependent segments on this platform.  */
+struct sysdep_value
+{
+  const char *name;
+  const char *value;
+};
+
+#ifdef PRIdMAX
+# define SYSDEP_VALUES(suffix) \
+  { "PRId" #suffix, PRId##suffix }, { "PRIi" #suffix, PRIi##suffix }, \
+  { "PRIo" #suffix, PRIo##suffix }, { "PRIu" #suffix, PRIu##suffix }, \
+  { "PRIx" #suffix, PRIx##suffix }, { "PRIX" #suffix, PRIX##suffix }
+#endif
+
+static const struct sysdep_value sysdep_values[] =
+{
+#ifdef PRIdMAX
+  SYSDEP_VALUES (8), SYSDEP_VALUES (16), SYSDEP_VALUES (32),
+  SYSDEP_VALUES (64),
+  SYSDEP_VALUES (LEAST8), SYSDEP_VALUES (LEAST16), SYSDEP_VALUES (LEAST32),
+  SYSDEP_VALUES (LEAST64),
+  SYSDEP_VALUES (FAST8), SYSDEP_VALUES (FAST16), SYSDEP_VALUES (FAST32),
+  SYSDEP_VALUES (FAST64),
+  SYSDEP_VALUES (MAX), SYSDEP_VALUES (PTR),
+#endif
+  /* The glibc specific printf() format directive flag 'I'.  This must
+     agree with get_sysdep_segment_value() in libintl.  */
+#if (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 2)) \
+    && !defined __UCLIBC__
+  { "I", "I" }
+#else
+  { "I", "" }
+#endif
+};
+
+/* Return the value on this platform of the system dependent segment given
+   by POINTER and LENGTH, or NULL if it is not known.  */
+static const char *
+sysdep_segment_value (const char *pointer, size_t length)
+{
+  size_t i;
+
+  for (i = 0; i < SIZEOF (sysdep_values); i++)
+    if (strlen (sysdep_values[i].name) == length
+        && memcmp (sysdep_values[i].name, pointer, length) == 0)
+      return sysdep_values[i].value;
+  return NULL;
+}
+
+/* Expand the system dependent segments of the string STR of length STR_LEN,
+   found at the NINTERVALS INTERVALS, to their values on this platform.
+   Return the result in freshly allocated memory, and its length in
+   *LENGTHP.  Return NULL if a segment has no known value.  */
+static char *
+expand_sysdep_string (const char *str, size_t str_len,
+                      const struct interval *intervals, size_t nintervals,
+                      size_t *lengthp)
+{
+  const char **values;
+  size_t length;
+  char *result;
+  char *q;
+  size_t lastpos;
+  size_t i;
+
+  values = XNMALLOC (nintervals, const char *);
+  length = str_len;
+  for (i = 0; i < nintervals; i++)
+    {
+      const char *pointer = str + intervals[i].startpos;
+      size_t seglength = intervals[i].endpos - intervals[i].startpos;
+
+      length -= seglength;
+      if (seglength >= 2
+          && pointer[0] == '<' && pointer[seglength - 1] == '>')
+        {
+          /* Skip the '<' and '>' markers.  */
+          seglength -= 2;
+          pointer += 1;
+        }
+      values[i] = sysdep_segment_value (pointer, seglength);
+      if (values[i] == NULL)
+        {
+          free (values);
+          return NULL;
+        }
+      length += strlen (values[i]);
+    }
+
+  result = XNMALLOC (length, char);
+  q = result;
+  lastpos = 0;
+  for (i = 0; i < nintervals; i++)
+    {
+      size_t value_len = strlen (values[i]);
+
+      memcpy (q, str + lastpos, intervals[i].startpos - lastpos);
+      q += intervals[i].startpos - lastpos;
+      memcpy (q, values[i], value_len);
+      q += value_len;
+      lastpos = intervals[i].endpos;
+    }
+  memcpy (q, str + lastpos, str_len - lastpos);
+
+  free (values);
+  *lengthp = length;
+  return result;
+}
+
 /* An intermediate data structure representing a 'struct sysdep_segment'.  */
 struct pre_sysdep_segment
 {
@@ -140,11 +277,471 @@ struct pre_sysdep_message
   size_t id_plural_len;
 };
 
-/* Write the message list to the given open file.  */
+/* Compute a minimal perfect hash table for the NSTRINGS original strings
+   in MSG_ARR, as described in gmo.h, following the "hash, displace, and
+   compress" algorithm by D. Belazzougui, F. C. Botelho, M. Dietzfelbinger
+   (without the compression).  Return true and the tables in *N_BUCKETSP,
+   *DISPLP, *TABP if successful, or false if no such table was found.  */
+static bool
+compute_perfect_hash (const struct pre_message *msg_arr, size_t nstrings,
+                      nls_uint32 *n_bucketsp,
+                      nls_uint32 **displp, nls_uint32 **tabp)
+{
+  nls_uint32 n_buckets;
+  nls_uint32 *pjw_hash;
+  nls_uint32 *fnv_hash;
+  size_t *bucket_start;
+  size_t *bucket_members;
+  size_t *bucket_order;
+  nls_uint32 *displ;
+  nls_uint32 *tab;
+  size_t *slots;
+  nls_uint32 max_displ;
+  size_t b, j, k;
+  bool ok;
+
+  /* About four strings per bucket.  */
+  n_buckets = nstrings / 4 + 1;
+  /* Give up if a bucket cannot be placed after trying as many
+     displacements as there are slots, many times over.  */
+  max_displ = (nstrings < 0x1000000 ? 256 * (nls_uint32) nstrings : 0);
+  if (max_displ < 0x10000)
+    max_displ = 0x10000;
+
+  /* Distribute the strings among the buckets.  */
+  pjw_hash = XNMALLOC (nstrings, nls_uint32);
+  fnv_hash = XNMALLOC (nstrings, nls_uint32);
+  bucket_start = XCALLOC (n_buckets + 1, size_t);
+  bucket_members = XNMALLOC (nstrings, size_t);
+  for (j = 0; j < nstrings; j++)
+    {
+      pjw_hash[j] = hash_string (msg_arr[j].str[M_ID].pointer);
+      fnv_hash[j] = hash_string_fnv (msg_arr[j].str[M_ID].pointer);
+      bucket_start[fnv_hash[j] % n_buckets + 1]++;
+    }
+  for (b = 0; b < n_buckets; b++)
+    bucket_start[b + 1] += bucket_start[b];
+  {
+    size_t *fill = XNMALLOC (n_buckets, size_t);
+
+    memcpy (fill, bucket_start, n_buckets * sizeof (size_t));
+    for (j = 0; j < nstrings; j++)
+      bucket_members[fill[fnv_hash[j] % n_buckets]++] = j;
+    free (fill);
+  }
+
+  /* Place the largest buckets first, while most slots are free.  Sort the
+     buckets by decreasing size, using a counting sort.  */
+  bucket_order = XNMALLOC (n_buckets, size_t);
+  {
+    size_t max_size = 0;
+    size_t *count;
+    size_t size;
+
+    for (b = 0; b < n_buckets; b++)
+      if (max_size < bucket_start[b + 1] - bucket_start[b])
+        max_size = bucket_start[b + 1] - bucket_start[b];
+    count = XCALLOC (max_size + 2, size_t);
+    for (b = 0; b < n_buckets; b++)
+      count[max_size - (bucket_start[b + 1] - bucket_start[b]) + 1]++;
+    for (size = 0; size <= max_size; size++)
+      count[size + 1] += count[size];
+    for (b = 0; b < n_buckets; b++)
+      {
+        size = bucket_start[b + 1] - bucket_start[b];
+        bucket_order[count[max_size - size]++] = b;
+      }
+    free (count);
+  }
+
+  displ = XCALLOC (n_buckets, nls_uint32);
+  tab = XNMALLOC (nstrings, nls_uint32);
+  {
+    bool *occupied = XCALLOC (nstrings, bool);
+
+    slots = XNMALLOC (nstrings, size_t);
+    ok = true;
+    for (k = 0; k < n_buckets && ok; k++)
+      {
+        size_t start, size;
+        nls_uint32 d;
+
+        b = bucket_order[k];
+        start = bucket_start[b];
+        size = bucket_start[b + 1] - start;
+        if (size == 0)
+          /* This and all remaining buckets are empty.  */
+          break;
+
+        for (d = 0; d < max_displ; d++)
+          {
+            size_t i;
+
+            for (i = 0; i < size; i++)
+              {
+                size_t member = bucket_members[start + i];
+                size_t slot =
+                  hash_string_slot (pjw_hash[member], fnv_hash[member], d)
+                  % nstrings;
+                size_t i2;
+
+                if (occupied[slot])
+                  break;
+                for (i2 = 0; i2 < i; i2++)
+                  if (slots[i2] == slot)
+                    break;
+                if (i2 < i)
+                  break;
+                slots[i] = slot;
+              }
+            if (i == size)
+              break;
+          }
+        if (d == max_displ)
+          ok = false;
+        else
+          {
+            size_t i;
+
+            displ[b] = d;
+            for (i = 0; i < size; i++)
+              {
+                occupied[slots[i]] = true;
+                tab[slots[i]] = bucket_members[start + i];
+              }
+          }
+      }
+    free (occupied);
+  }
+
+  free (slots);
+  free (bucket_order);
+  free (bucket_members);
+  free (bucket_start);
+  free (fnv_hash);
+  free (pjw_hash);
+
+  if (!ok)
+    {
+      free (tab);
+      free (displ);
+      return false;
+    }
+
+  *n_bucketsp = n_buckets;
+  *displp = displ;
+  *tabp = tab;
+  return true;
+}
+
+
+/* A static string of the .mo file, as it appears in the file, including
+   the msgid_plural of a msgid and the trailing NUL.  */
+struct pool_string
+{
+  const char *pointer;
+  size_t length;
+  /* 2 * index in msg_arr + M_ID or M_STR.  */
+  size_t index;
+};
+
+/* Compare two strings by their bytes in reverse order, so that a string
+   comes right before the strings that end with it.  */
+static int
+compare_reversed (const void *pval1, const void *pval2)
+{
+  const struct pool_string *s1 = (const struct pool_string *) pval1;
+  const struct pool_string *s2 = (const struct pool_string *) pval2;
+  const unsigned char *p1 = (const unsigned char *) s1->pointer + s1->length;
+  const unsigned char *p2 = (const unsigned char *) s2->pointer + s2->length;
+  size_t n = (s1->length < s2->length ? s1->length : s2->length);
+
+  for (; n > 0; n--)
+    {
+      p1--;
+      p2--;
+      if (*p1 != *p2)
+        return (int) *p1 - (int) *p2;
+    }
+  return (s1->length > s2->length) - (s1->length < s2->length);
+}
+
+/* Find out which of the static strings in MSG_ARR can reuse the bytes of
+   another one.  String K, where K is 2 * index in MSG_ARR + M_ID or M_STR,
+   is stored as the last bytes of string OWNERS[K].  If OWNERS[K] == K, it
+   is stored on its own.  When the strings are aligned, only equal strings
+   are shared, since the end of a string is usually not aligned.  Return
+   the array OWNERS.  */
+static size_t *
+compute_shared_strings (const struct pre_message *msg_arr, size_t nstrings)
+{
+  struct pool_string *pool = XNMALLOC (2 * nstrings, struct pool_string);
+  size_t *owners = XNMALLOC (2 * nstrings, size_t);
+  size_t j;
+  size_t i;
+
+  for (j = 0; j < nstrings; j++)
+    {
+      const struct pre_message *msg = &msg_arr[j];
+
+      if (msg->id_plural_len > 0)
+        {
+          /* The msgid_plural follows the msgid in the file.  */
+          char *concat =
+            XNMALLOC (msg->str[M_ID].length + msg->id_plural_len, char);
+
+          memcpy (concat, msg->str[M_ID].pointer, msg->str[M_ID].length);
+          memcpy (concat + msg->str[M_ID].length, msg->id_plural,
+                  msg->id_plural_len);
+          pool[2 * j + M_ID].pointer = concat;
+        }
+      else
+        pool[2 * j + M_ID].pointer = msg->str[M_ID].pointer;
+      pool[2 * j + M_ID].length = msg->str[M_ID].length + msg->id_plural_len;
+      pool[2 * j + M_ID].index = 2 * j + M_ID;
+      pool[2 * j + M_STR].pointer = msg->str[M_STR].pointer;
+      pool[2 * j + M_STR].length = msg->str[M_STR].length;
+      pool[2 * j + M_STR].index = 2 * j + M_STR;
+    }
+
+  qsort (pool, 2 * nstrings, sizeof (struct pool_string), compare_reversed);
+
+  /* If a string is the end of some other string, it is the end of the
+     string that follows it in sorted order.  Going backwards, that string
+     already knows its owner.  */
+  for (i = 2 * nstrings; i-- > 0; )
+    {
+      const struct pool_string *str = &pool[i];
+      const struct pool_string *next = &pool[i + 1];
+
+      if (i + 1 < 2 * nstrings
+          && (alignment == 1
+              ? str->length <= next->length
+              : str->length == next->length)
+          && memcmp (str->pointer,
+                     next->pointer + next->length - str->length,
+                     str->length) == 0)
+        owners[str->index] = owners[next->index];
+      else
+        owners[str->index] = str->index;
+    }
+
+  for (i = 0; i < 2 * nstrings; i++)
+    if (pool[i].index % 2 == M_ID
+        && msg_arr[pool[i].index / 2].id_plural_len > 0)
+      free ((char *) pool[i].pointer);
+  free (pool);
+
+  return owners;
+}
+
+
+/* Size of the uncompressed contents of a compressed block, unless a single
+   translated string is larger.  Smaller blocks waste less time when only a
+   few translations of a catalog are used, larger blocks compress better.  */
+#define COMPRESSED_BLOCK_SIZE 16384
+
+/* Number of entries of the hash table of the compressor.  */
+#define LZ_HASH_BITS 13
+
+/* Store a literal or match length LEN, minus the part of it that is in
+   the token, at DST.  Return the position after it.  */
+static unsigned char *
+lz_put_length (unsigned char *dst, size_t len)
+{
+  for (; len >= 255; len -= 255)
+    *dst++ = 255;
+  *dst++ = len;
+  return dst;
+}
+
+/* Store a command with the literal bytes from LITERALS to SRC, and, if
+   MATCH_LEN > 0, a match of MATCH_LEN bytes at DISTANCE, at DST.  Return
+   the position after it.  */
+static unsigned char *
+lz_put_command (unsigned char *dst,
+                const unsigned char *literals, const unsigned char *src,
+                size_t distance, size_t match_len)
+{
+  size_t literal_len = src - literals;
+  unsigned char *token = dst++;
+
+  *token = (literal_len < 15 ? literal_len : 15) << 4;
+  if (literal_len >= 15)
+    dst = lz_put_length (dst, literal_len - 15);
+  memcpy (dst, literals, literal_len);
+  dst += literal_len;
+
+  if (match_len > 0)
+    {
+      match_len -= LZ_BLOCK_MIN_MATCH;
+      *dst++ = distance & 0xff;
+      *dst++ = distance >> 8;
+      *token |= (match_len < 15 ? match_len : 15);
+      if (match_len >= 15)
+        dst = lz_put_length (dst, match_len - 15);
+    }
+  return dst;
+}
+
+/* Compress the SRCLEN bytes at SRC into a block in the format described in
+   "lz-block.h", at DST.  DST must have room for SRCLEN + SRCLEN / 255 + 16
+   bytes.  Return the length of the block.  The compressor is greedy: it
+   takes the most recent earlier occurrence of the next 4 bytes, if any,
+   and extends it as far as possible.  */
+static size_t
+lz_block_encode (const char *src_param, size_t srclen, char *dst_param)
+{
+  const unsigned char *src = (const unsigned char *) src_param;
+  const unsigned char *src_end = src + srclen;
+  unsigned char *dst = (unsigned char *) dst_param;
+  /* Maps the hash code of 4 bytes to 1 + the last position where they
+     occurred, or 0.  */
+  size_t *last = XCALLOC (1 << LZ_HASH_BITS, size_t);
+  const unsigned char *literals = src;
+  const unsigned char *p = src;
+
+  while (src_end - p >= LZ_BLOCK_MIN_MATCH)
+    {
+      nls_uint32 word = p[0] | (p[1] << 8) | (p[2] << 16)
+                        | ((nls_uint32) p[3] << 24);
+      size_t hash = ((word * 2654435761U) & 0xffffffffU)
+                    >> (32 - LZ_HASH_BITS);
+      size_t candidate = last[hash];
+
+      last[hash] = p - src + 1;
+      if (candidate > 0
+          && (size_t) (p - src) - (candidate - 1) <= LZ_BLOCK_MAX_DISTANCE
+          && memcmp (src + candidate - 1, p, LZ_BLOCK_MIN_MATCH) == 0)
+        {
+          const unsigned char *match = src + candidate - 1;
+          size_t match_len = LZ_BLOCK_MIN_MATCH;
+
+          while (p + match_len < src_end && match[match_len] == p[match_len])
+            match_len++;
+          dst = lz_put_command (dst, literals, p, p - match, match_len);
+          p += match_len;
+          literals = p;
+        }
+      else
+        p++;
+    }
+  /* The last command has only literal bytes.  */
+  dst = lz_put_command (dst, literals, src_end, 0, 0);
+
+  free (last);
+  return dst - (unsigned char *) dst_param;
+}
+
+/* Lay out the static translated strings in MSG_ARR in compressed blocks.
+   Store the offset of each string in the concatenation of the uncompressed
+   contents of the blocks in TRANS_OFFSETS.  Return the number of blocks,
+   their descriptors, whose offset fields are relative to the start of the
+   compressed data, and the compressed data and its length.  */
 static void
-write_table (FILE *output_file, message_list_ty *mlp)
+compress_translations (const struct pre_message *msg_arr, size_t nstrings,
+                       nls_uint32 *trans_offsets,
+                       size_t *n_blocksp, struct compressed_block **blocksp,
+                       char **datap, size_t *lengthp)
+{
+  size_t n_blocks;
+  struct compressed_block *blocks;
+  size_t total;
+  size_t block_start;
+  char *contents;
+  char *data;
+  size_t length;
+  size_t j;
+
+  /* Place the strings, so that none crosses a block boundary.  */
+  n_blocks = 0;
+  blocks = XNMALLOC (nstrings, struct compressed_block);
+  total = 0;
+  block_start = 0;
+  for (j = 0; j < nstrings; j++)
+    {
+      size_t offset = roundup (total, alignment);
+      size_t str_len = msg_arr[j].str[M_STR].length;
+
+      if (total > block_start
+          && offset + str_len - block_start > COMPRESSED_BLOCK_SIZE)
+        {
+          blocks[n_blocks].start = block_start;
+          blocks[n_blocks].size = total - block_start;
+          n_blocks++;
+          block_start = offset;
+        }
+      trans_offsets[j] = offset;
+      total = offset + str_len;
+    }
+  if (total > block_start)
+    {
+      blocks[n_blocks].start = block_start;
+      blocks[n_blocks].size = total - block_start;
+      n_blocks++;
+    }
+
+  contents = XNMALLOC (total, char);
+  memset (contents, '\0', total);
+  for (j = 0; j < nstrings; j++)
+    memcpy (contents + trans_offsets[j], msg_arr[j].str[M_STR].pointer,
+            msg_arr[j].str[M_STR].length);
+
+  /* Compress each block.  */
+  data = XNMALLOC (xsum (total + total / 255, 16 * n_blocks), char);
+  length = 0;
+  for (j = 0; j < n_blocks; j++)
+    {
+      blocks[j].offset = length;
+      blocks[j].length =
+        lz_block_encode (contents + blocks[j].start, blocks[j].size,
+                         data + length);
+      length += blocks[j].length;
+    }
+
+  free (contents);
+
+  *n_blocksp = n_blocks;
+  *blocksp = blocks;
+  *datap = data;
+  *lengthp = length;
+}
+
+
+/* The contents of a .mo file, assembled in memory so that the file can be
+   written out at once.  */
+struct mo_image
+{
+  char *data;
+  size_t length;
+  size_t allocated;
+};
+
+/* Append LENGTH bytes at DATA to IMAGE.  */
+static void
+image_append (struct mo_image *image, const void *data, size_t length)
+{
+  if (length == 0)
+    return;
+  if (image->length + length > image->allocated)
+    {
+      size_t new_allocated = 2 * image->allocated;
+
+      if (new_allocated < image->length + length)
+        new_allocated = image->length + length;
+      image->data = (char *) xrealloc (image->data, new_allocated);
+      image->allocated = new_allocated;
+    }
+  memcpy (image->data + image->length, data, length);
+  image->length += length;
+}
+
+/* Store the .mo file contents for the message list in IMAGE.  */
+static void
+write_table (struct mo_image *image, message_list_ty *mlp)
 {
   char **msgctid_arr;
+  char **msgstr_arr;
   size_t nstrings;
   struct pre_message *msg_arr;
   size_t n_sysdep_strings;
@@ -156,7 +753,19 @@ write_table (FILE *output_file, message_list_ty *mlp)
   int minor_revision;
   bool omit_hash_table;
   nls_uint32 hash_tab_size;
+  nls_uint32 *hash_tab;
+  nls_uint32 phash_n_buckets;
+  nls_uint32 *phash_displ;
+  nls_uint32 *phash_tab;
+  size_t *order;
+  size_t *owners;
+  nls_uint32 *trans_offsets;
+  size_t n_blocks;
+  struct compressed_block *blocks;
+  char *compressed_data;
+  size_t compressed_length;
   struct mo_file_header header; /* Header of the .mo file to be written.  */
+  struct mo_file_compression compression;
   size_t header_size;
   size_t offset;
   struct string_desc *orig_tab;
@@ -170,6 +779,7 @@ write_table (FILE *output_file, message_list_ty *mlp)
      and at the same time, compute the segments of the system dependent
      strings.  */
   msgctid_arr = XNMALLOC (mlp->nitems, char *);
+  msgstr_arr = XCALLOC (mlp->nitems, char *);
   nstrings = 0;
   msg_arr = XNMALLOC (mlp->nitems, struct pre_message);
   n_sysdep_strings = 0;
@@ -182,6 +792,9 @@ write_table (FILE *output_file, message_list_ty *mlp)
       message_ty *mp = mlp->item[j];
       size_t msgctlen;
       char *msgctid;
+      size_t msgctid_len;
+      const char *msgstr;
+      size_t msgstr_len;
       struct interval *intervals[2];
       size_t nintervals[2];
 
@@ -195,6 +808,9 @@ write_table (FILE *output_file, message_list_ty *mlp)
         }
       strcpy (msgctid + msgctlen, mp->msgid);
       msgctid_arr[j] = msgctid;
+      msgctid_len = strlen (msgctid) + 1;
+      msgstr = mp->msgstr;
+      msgstr_len = mp->msgstr_len;
 
       intervals[M_ID] = NULL;
       nintervals[M_ID] = 0;
@@ -262,6 +878,38 @@ write_table (FILE *output_file, message_list_ty *mlp)
             }
         }
 
+      if ((nintervals[M_ID] > 0 || nintervals[M_STR] > 0)
+          && expand_sysdep_strings)
+        {
+          /* Turn the string pair into a static string pair, if the values
+             of all its segments are known here.  */
+          size_t expanded_id_len;
+          size_t expanded_str_len;
+          char *expanded_id =
+            expand_sysdep_string (msgctid, msgctid_len,
+                                  intervals[M_ID], nintervals[M_ID],
+                                  &expanded_id_len);
+          char *expanded_str =
+            (expanded_id != NULL
+             ? expand_sysdep_string (mp->msgstr, mp->msgstr_len,
+                                     intervals[M_STR], nintervals[M_STR],
+                                     &expanded_str_len)
+             : NULL);
+
+          if (expanded_str != NULL)
+            {
+              free (msgctid);
+              msgctid = msgctid_arr[j] = expanded_id;
+              msgctid_len = expanded_id_len;
+              msgstr = msgstr_arr[j] = expanded_str;
+              msgstr_len = expanded_str_len;
+              nintervals[M_ID] = 0;
+              nintervals[M_STR] = 0;
+            }
+          else if (expanded_id != NULL)
+            free (expanded_id);
+        }
+
       if (nintervals[M_ID] > 0 || nintervals[M_STR] > 0)
         {
           /* System dependent string pair.  */
@@ -349,9 +997,9 @@ write_table (FILE *output_file, message_list_ty *mlp)
         {
           /* Static string pair.  */
           msg_arr[nstrings].str[M_ID].pointer = msgctid;
-          msg_arr[nstrings].str[M_ID].length = strlen (msgctid) + 1;
-          msg_arr[nstrings].str[M_STR].pointer = mp->msgstr;
-          msg_arr[nstrings].str[M_STR].length = mp->msgstr_len;
+          msg_arr[nstrings].str[M_ID].length = msgctid_len;
+          msg_arr[nstrings].str[M_STR].pointer = msgstr;
+          msg_arr[nstrings].str[M_STR].length = msgstr_len;
           msg_arr[nstrings].id_plural = mp->msgid_plural;
           msg_arr[nstrings].id_plural_len =
             (mp->msgid_plural != NULL ? strlen (mp->msgid_plural) + 1 : 0);
@@ -373,6 +1021,11 @@ write_table (FILE *output_file, message_list_ty *mlp)
   major_revision =
     (have_outdigits ? MO_REVISION_NUMBER_WITH_SYSDEP_I : MO_REVISION_NUMBER);
 
+  /* We need major revision 2 for the compressed translations.  Older
+     versions of gettext() reject it, rather than returning garbage.  */
+  if (compress_strings)
+    major_revision = MO_REVISION_NUMBER_COMPRESSED;
+
   /* We need minor revision 1 if there are system dependent strings.
      Otherwise we choose minor revision 0 because it's supported by older
      versions of libintl and revision 1 isn't.  */
@@ -411,20 +1064,119 @@ write_table (FILE *output_file, message_list_ty *mlp)
   else
     hash_tab_size = 0;
 
+  if (!omit_hash_table)
+    {
+      /* Allocate room for the hashing table to be written out.  */
+      hash_tab = XNMALLOC (hash_tab_size, nls_uint32);
+      memset (hash_tab, '\0', hash_tab_size * sizeof (nls_uint32));
+
+      /* Insert all value in the hash table, following the algorithm described
+         above.  */
+      for (j = 0; j < nstrings; j++)
+        {
+          nls_uint32 hash_val = hash_string (msg_arr[j].str[M_ID].pointer);
+          nls_uint32 idx = hash_val % hash_tab_size;
+
+          if (hash_tab[idx] != 0)
+            {
+              /* We need the second hashing function.  */
+              nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
+
+              do
+                if (idx >= hash_tab_size - incr)
+                  idx -= hash_tab_size - incr;
+                else
+                  idx += incr;
+              while (hash_tab[idx] != 0);
+            }
+
+          hash_tab[idx] = j + 1;
+        }
+    }
+  else
+    hash_tab = NULL;
+
+  /* The perfect hash table is optional, and supplements the hash table.
+     It cannot find system dependent strings.  */
+  phash_n_buckets = 0;
+  phash_displ = NULL;
+  phash_tab = NULL;
+  if (perfect_hash_table && !omit_hash_table && n_sysdep_strings == 0
+      && nstrings > 0
+      && compute_perfect_hash (msg_arr, nstrings,
+                               &phash_n_buckets, &phash_displ, &phash_tab))
+    /* We need minor revision 2 for the perfect hash table.  */
+    minor_revision = 2;
+
+  /* When the original strings and their translations are interleaved, the
+     string pairs are laid out in the order of the hash table slots that
+     refer to them, or in sorted order when there is no hash table.  The
+     tables of string descriptors remain sorted, for the binary search.  */
+  if (interleave_strings && !compress_strings)
+    {
+      order = XNMALLOC (nstrings, size_t);
+      if (hash_tab != NULL)
+        {
+          size_t k = 0;
+          nls_uint32 idx;
+
+          for (idx = 0; idx < hash_tab_size; idx++)
+            if (hash_tab[idx] != 0)
+              order[k++] = hash_tab[idx] - 1;
+        }
+      else
+        for (j = 0; j < nstrings; j++)
+          order[j] = j;
+    }
+  else
+    order = NULL;
+
+  /* Find the strings that can be stored as part of another string.  */
+  owners =
+    (share_strings && !compress_strings && nstrings > 0
+     ? compute_shared_strings (msg_arr, nstrings)
+     : NULL);
+
+  /* Compress the static translated strings.  */
+  if (compress_strings)
+    {
+      trans_offsets = XNMALLOC (nstrings, nls_uint32);
+      compress_translations (msg_arr, nstrings, trans_offsets,
+                             &n_blocks, &blocks,
+                             &compressed_data, &compressed_length);
+    }
+  else
+    {
+      trans_offsets = NULL;
+      n_blocks = 0;
+      blocks = NULL;
+      compressed_data = NULL;
+      compressed_length = 0;
+    }
+
 
   /* Second pass: Fill the structure describing the header.  At the same time,
      compute the sizes and offsets of the non-string parts of the file.  */
 
+  /* The fields that are not used are zero.  */
+  memset (&header, '\0', sizeof (header));
+
   /* Magic number.  */
   header.magic = _MAGIC;
   /* Revision number of file format.  */
   header.revision = (major_revision << 16) + minor_revision;
 
+  /* In major revision 2, the header is complete and followed by the
+     description of the compressed blocks.  */
   header_size =
-    (minor_revision == 0
-     ? offsetof (struct mo_file_header, n_sysdep_segments)
-     : sizeof (struct mo_file_header));
+    (compress_strings || minor_revision >= 2
+     ? sizeof (struct mo_file_header)
+     : minor_revision == 1
+     ? offsetof (struct mo_file_header, phash_n_buckets)
+     : offsetof (struct mo_file_header, n_sysdep_segments));
   offset = header_size;
+  if (compress_strings)
+    offset += sizeof (struct mo_file_compression);
 
   /* Number of static string pairs.  */
   header.nstrings = nstrings;
@@ -445,6 +1197,18 @@ write_table (FILE *output_file, message_list_ty *mlp)
   header.hash_tab_offset = offset;
   offset += hash_tab_size * sizeof (nls_uint32);
 
+  if (minor_revision >= 2)
+    {
+      /* Number of buckets of the perfect hash table.  */
+      header.phash_n_buckets = phash_n_buckets;
+      /* Offset of table with the displacement of each bucket.  */
+      header.phash_displ_offset = offset;
+      offset += phash_n_buckets * sizeof (nls_uint32);
+      /* Offset of table with the string index in each slot.  */
+      header.phash_tab_offset = offset;
+      offset += nstrings * sizeof (nls_uint32);
+    }
+
   if (minor_revision >= 1)
     {
       /* Size of table describing system dependent segments.  */
@@ -473,6 +1237,15 @@ write_table (FILE *output_file, message_list_ty *mlp)
                       * sizeof (struct segment_pair);
     }
 
+  if (compress_strings)
+    {
+      /* Number of compressed blocks.  */
+      compression.n_blocks = n_blocks;
+      /* Offset of table describing the compressed blocks.  */
+      compression.blocks_offset = offset;
+      offset += n_blocks * sizeof (struct compressed_block);
+    }
+
   end_offset = offset;
 
 
@@ -497,94 +1270,165 @@ write_table (FILE *output_file, message_list_ty *mlp)
           BSWAP32 (header.orig_sysdep_tab_offset);
           BSWAP32 (header.trans_sysdep_tab_offset);
         }
+      if (minor_revision >= 2)
+        {
+          BSWAP32 (header.phash_n_buckets);
+          BSWAP32 (header.phash_displ_offset);
+          BSWAP32 (header.phash_tab_offset);
+        }
     }
-  fwrite (&header, header_size, 1, output_file);
+  image_append (image, &header, header_size);
 
-  /* Table for original string offsets.  */
-  /* Here output_file is at position header.orig_tab_offset.  */
+  if (compress_strings)
+    {
+      if (byteswap)
+        {
+          BSWAP32 (compression.n_blocks);
+          BSWAP32 (compression.blocks_offset);
+        }
+      image_append (image, &compression, sizeof (compression));
+    }
 
-  for (j = 0; j < nstrings; j++)
+  if (order != NULL)
+    {
+      size_t k;
+
+      for (k = 0; k < nstrings; k++)
+        {
+          j = order[k];
+
+          orig_tab[j].length =
+            msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
+          if (owners == NULL || owners[2 * j + M_ID] == 2 * j + M_ID)
+            {
+              offset = roundup (offset, alignment);
+              orig_tab[j].offset = offset;
+              offset += orig_tab[j].length;
+            }
+          /* Subtract 1 because of the terminating NUL.  */
+          orig_tab[j].length--;
+
+          trans_tab[j].length = msg_arr[j].str[M_STR].length;
+          if (owners == NULL || owners[2 * j + M_STR] == 2 * j + M_STR)
+            {
+              offset = roundup (offset, alignment);
+              trans_tab[j].offset = offset;
+              offset += trans_tab[j].length;
+            }
+          /* Subtract 1 because of the terminating NUL.  */
+          trans_tab[j].length--;
+        }
+    }
+  else
     {
-      offset = roundup (offset, alignment);
-      orig_tab[j].length =
-        msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
-      orig_tab[j].offset = offset;
-      offset += orig_tab[j].length;
-      /* Subtract 1 because of the terminating NUL.  */
-      orig_tab[j].length--;
+      for (j = 0; j < nstrings; j++)
+        {
+          orig_tab[j].length =
+            msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
+          if (owners == NULL || owners[2 * j + M_ID] == 2 * j + M_ID)
+            {
+              offset = roundup (offset, alignment);
+              orig_tab[j].offset = offset;
+              offset += orig_tab[j].length;
+            }
+          /* Subtract 1 because of the terminating NUL.  */
+          orig_tab[j].length--;
+        }
+
+      for (j = 0; j < nstrings; j++)
+        {
+          trans_tab[j].length = msg_arr[j].str[M_STR].length;
+          if (trans_offsets != NULL)
+            /* The string is in a compressed block.  */
+            trans_tab[j].offset = trans_offsets[j];
+          else if (owners == NULL || owners[2 * j + M_STR] == 2 * j + M_STR)
+            {
+              offset = roundup (offset, alignment);
+              trans_tab[j].offset = offset;
+              offset += trans_tab[j].length;
+            }
+          /* Subtract 1 because of the terminating NUL.  */
+          trans_tab[j].length--;
+        }
+
+      /* The compressed blocks follow the original strings.  */
+      for (j = 0; j < n_blocks; j++)
+        blocks[j].offset += offset;
+      offset += compressed_length;
     }
+
+  /* A shared string is at the end of the string that holds its bytes.  */
+  if (owners != NULL)
+    for (j = 0; j < 2 * nstrings; j++)
+      if (owners[j] != j)
+        {
+          struct string_desc *desc =
+            (j % 2 == M_ID ? &orig_tab[j / 2] : &trans_tab[j / 2]);
+          const struct string_desc *owner_desc =
+            (owners[j] % 2 == M_ID
+             ? &orig_tab[owners[j] / 2]
+             : &trans_tab[owners[j] / 2]);
+
+          desc->offset =
+            owner_desc->offset + owner_desc->length - desc->length;
+        }
+
+  /* Table for original string offsets.  */
+  /* Here output_file is at position header.orig_tab_offset.  */
+
   if (byteswap)
     for (j = 0; j < nstrings; j++)
       {
         BSWAP32 (orig_tab[j].length);
         BSWAP32 (orig_tab[j].offset);
       }
-  fwrite (orig_tab, nstrings * sizeof (struct string_desc), 1, output_file);
+  image_append (image, orig_tab, nstrings * sizeof (struct string_desc));
 
   /* Table for translated string offsets.  */
   /* Here output_file is at position header.trans_tab_offset.  */
 
-  for (j = 0; j < nstrings; j++)
-    {
-      offset = roundup (offset, alignment);
-      trans_tab[j].length = msg_arr[j].str[M_STR].length;
-      trans_tab[j].offset = offset;
-      offset += trans_tab[j].length;
-      /* Subtract 1 because of the terminating NUL.  */
-      trans_tab[j].length--;
-    }
   if (byteswap)
     for (j = 0; j < nstrings; j++)
       {
         BSWAP32 (trans_tab[j].length);
         BSWAP32 (trans_tab[j].offset);
       }
-  fwrite (trans_tab, nstrings * sizeof (struct string_desc), 1, output_file);
+  image_append (image, trans_tab, nstrings * sizeof (struct string_desc));
 
   /* Skip this part when no hash table is needed.  */
   if (!omit_hash_table)
     {
-      nls_uint32 *hash_tab;
       unsigned int j;
 
       /* Here output_file is at position header.hash_tab_offset.  */
 
-      /* Allocate room for the hashing table to be written out.  */
-      hash_tab = XNMALLOC (hash_tab_size, nls_uint32);
-      memset (hash_tab, '\0', hash_tab_size * sizeof (nls_uint32));
-
-      /* Insert all value in the hash table, following the algorithm described
-         above.  */
-      for (j = 0; j < nstrings; j++)
-        {
-          nls_uint32 hash_val = hash_string (msg_arr[j].str[M_ID].pointer);
-          nls_uint32 idx = hash_val % hash_tab_size;
-
-          if (hash_tab[idx] != 0)
-            {
-              /* We need the second hashing function.  */
-              nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
-
-              do
-                if (idx >= hash_tab_size - incr)
-                  idx -= hash_tab_size - incr;
-                else
-                  idx += incr;
-              while (hash_tab[idx] != 0);
-            }
-
-          hash_tab[idx] = j + 1;
-        }
-
       /* Write the hash table out.  */
       if (byteswap)
         for (j = 0; j < hash_tab_size; j++)
           BSWAP32 (hash_tab[j]);
-      fwrite (hash_tab, hash_tab_size * sizeof (nls_uint32), 1, output_file);
+      image_append (image, hash_tab, hash_tab_size * sizeof (nls_uint32));
 
       free (hash_tab);
     }
 
+  if (minor_revision >= 2)
+    {
+      /* Here output_file is at position header.phash_displ_offset.  */
+
+      if (byteswap)
+        {
+          for (j = 0; j < phash_n_buckets; j++)
+            BSWAP32 (phash_displ[j]);
+          for (j = 0; j < nstrings; j++)
+            BSWAP32 (phash_tab[j]);
+        }
+      image_append (image, phash_displ, phash_n_buckets * sizeof (nls_uint32));
+      image_append (image, phash_tab, nstrings * sizeof (nls_uint32));
+
+      free (phash_tab);
+      free (phash_displ);
+    }
+
   if (minor_revision >= 1)
     {
       struct sysdep_segment *sysdep_segments_tab;
@@ -611,9 +1455,8 @@ write_table (FILE *output_file, message_list_ty *mlp)
             BSWAP32 (sysdep_segments_tab[i].length);
             BSWAP32 (sysdep_segments_tab[i].offset);
           }
-      fwrite (sysdep_segments_tab,
-              n_sysdep_segments * sizeof (struct sysdep_segment), 1,
-              output_file);
+      image_append (image, sysdep_segments_tab,
+                    n_sysdep_segments * sizeof (struct sysdep_segment));
 
       free (sysdep_segments_tab);
 
@@ -637,8 +1480,8 @@ write_table (FILE *output_file, message_list_ty *mlp)
           if (byteswap)
             for (j = 0; j < n_sysdep_strings; j++)
               BSWAP32 (sysdep_tab[j]);
-          fwrite (sysdep_tab, n_sysdep_strings * sizeof (nls_uint32), 1,
-                  output_file);
+          image_append (image, sysdep_tab,
+                        n_sysdep_strings * sizeof (nls_uint32));
         }
 
       free (sysdep_tab);
@@ -678,15 +1521,31 @@ write_table (FILE *output_file, message_list_ty *mlp)
                     BSWAP32 (str->segments[i].sysdepref);
                   }
               }
-            fwrite (str,
-                    sizeof (struct sysdep_string)
-                    + pre->segmentcount * sizeof (struct segment_pair),
-                    1, output_file);
+            image_append (image, str,
+                          sizeof (struct sysdep_string)
+                          + pre->segmentcount * sizeof (struct segment_pair));
 
             freea (str);
           }
     }
 
+  if (compress_strings)
+    {
+      /* Here output_file is at position compression.blocks_offset.  */
+
+      if (byteswap)
+        for (j = 0; j < n_blocks; j++)
+          {
+            BSWAP32 (blocks[j].length);
+            BSWAP32 (blocks[j].offset);
+            BSWAP32 (blocks[j].start);
+            BSWAP32 (blocks[j].size);
+          }
+      image_append (image, blocks, n_blocks * sizeof (struct compressed_block));
+
+      free (blocks);
+    }
+
   /* Here output_file is at position end_offset.  */
 
   free (trans_tab);
@@ -695,35 +1554,96 @@ write_table (FILE *output_file, message_list_ty *mlp)
 
   /* Fourth pass: Write the strings.  */
 
+  /* Here offset is the size of the entire file.  */
+  if (image->allocated < offset)
+    {
+      image->data = (char *) xrealloc (image->data, offset);
+      image->allocated = offset;
+    }
+
   offset = end_offset;
 
   /* A few zero bytes for padding.  */
   null = (char *) alloca (alignment);
   memset (null, '\0', alignment);
 
-  /* Now write the original strings.  */
-  for (j = 0; j < nstrings; j++)
+  if (order != NULL)
     {
-      fwrite (null, roundup (offset, alignment) - offset, 1, output_file);
-      offset = roundup (offset, alignment);
+      size_t k;
 
-      fwrite (msg_arr[j].str[M_ID].pointer, msg_arr[j].str[M_ID].length, 1,
-              output_file);
-      if (msg_arr[j].id_plural_len > 0)
-        fwrite (msg_arr[j].id_plural, msg_arr[j].id_plural_len, 1,
-                output_file);
-      offset += msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
-    }
+      /* Now write each original string, followed by its translation.  */
+      for (k = 0; k < nstrings; k++)
+        {
+          j = order[k];
 
-  /* Now write the translated strings.  */
-  for (j = 0; j < nstrings; j++)
+          if (owners == NULL || owners[2 * j + M_ID] == 2 * j + M_ID)
+            {
+              image_append (image, null,
+                            roundup (offset, alignment) - offset);
+              offset = roundup (offset, alignment);
+
+              image_append (image, msg_arr[j].str[M_ID].pointer,
+                            msg_arr[j].str[M_ID].length);
+              if (msg_arr[j].id_plural_len > 0)
+                image_append (image, msg_arr[j].id_plural,
+                              msg_arr[j].id_plural_len);
+              offset +=
+                msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
+            }
+
+          if (owners == NULL || owners[2 * j + M_STR] == 2 * j + M_STR)
+            {
+              image_append (image, null,
+                            roundup (offset, alignment) - offset);
+              offset = roundup (offset, alignment);
+
+              image_append (image, msg_arr[j].str[M_STR].pointer,
+                            msg_arr[j].str[M_STR].length);
+              offset += msg_arr[j].str[M_STR].length;
+            }
+        }
+    }
+  else
     {
-      fwrite (null, roundup (offset, alignment) - offset, 1, output_file);
-      offset = roundup (offset, alignment);
+      /* Now write the original strings.  */
+      for (j = 0; j < nstrings; j++)
+        {
+          if (owners == NULL || owners[2 * j + M_ID] == 2 * j + M_ID)
+            {
+              image_append (image, null,
+                            roundup (offset, alignment) - offset);
+              offset = roundup (offset, alignment);
+
+              image_append (image, msg_arr[j].str[M_ID].pointer,
+                            msg_arr[j].str[M_ID].length);
+              if (msg_arr[j].id_plural_len > 0)
+                image_append (image, msg_arr[j].id_plural,
+                              msg_arr[j].id_plural_len);
+              offset +=
+                msg_arr[j].str[M_ID].length + msg_arr[j].id_plural_len;
+            }
+        }
 
-      fwrite (msg_arr[j].str[M_STR].pointer, msg_arr[j].str[M_STR].length, 1,
-              output_file);
-      offset += msg_arr[j].str[M_STR].length;
+      /* Now write the translated strings.  */
+      if (compressed_data != NULL)
+        {
+          image_append (image, compressed_data, compressed_length);
+          offset += compressed_length;
+        }
+      else
+        for (j = 0; j < nstrings; j++)
+          {
+            if (owners == NULL || owners[2 * j + M_STR] == 2 * j + M_STR)
+              {
+                image_append (image, null,
+                              roundup (offset, alignment) - offset);
+                offset = roundup (offset, alignment);
+
+                image_append (image, msg_arr[j].str[M_STR].pointer,
+                              msg_arr[j].str[M_STR].length);
+                offset += msg_arr[j].str[M_STR].length;
+              }
+          }
     }
 
   if (minor_revision >= 1)
@@ -732,12 +1652,12 @@ write_table (FILE *output_file, message_list_ty *mlp)
 
       for (i = 0; i < n_sysdep_segments; i++)
         {
-          fwrite (null, roundup (offset, alignment) - offset, 1, output_file);
+          image_append (image, null, roundup (offset, alignment) - offset);
           offset = roundup (offset, alignment);
 
-          fwrite (sysdep_segments[i].pointer, sysdep_segments[i].length, 1,
-                  output_file);
-          fwrite (null, 1, 1, output_file);
+          image_append (image, sysdep_segments[i].pointer,
+                        sysdep_segments[i].length);
+          image_append (image, null, 1);
           offset += sysdep_segments[i].length + 1;
         }
 
@@ -747,19 +1667,18 @@ write_table (FILE *output_file, message_list_ty *mlp)
             struct pre_sysdep_message *msg = &sysdep_msg_arr[j];
             struct pre_sysdep_string *pre = msg->str[m];
 
-            fwrite (null, roundup (offset, alignment) - offset, 1,
-                    output_file);
+            image_append (image, null, roundup (offset, alignment) - offset);
             offset = roundup (offset, alignment);
 
             for (i = 0; i <= pre->segmentcount; i++)
               {
-                fwrite (pre->segments[i].segptr, pre->segments[i].segsize, 1,
-                        output_file);
+                image_append (image, pre->segments[i].segptr,
+                              pre->segments[i].segsize);
                 offset += pre->segments[i].segsize;
               }
             if (m == M_ID && msg->id_plural_len > 0)
               {
-                fwrite (msg->id_plural, msg->id_plural_len, 1, output_file);
+                image_append (image, msg->id_plural, msg->id_plural_len);
                 offset += msg->id_plural_len;
               }
 
@@ -768,50 +1687,350 @@ write_table (FILE *output_file, message_list_ty *mlp)
     }
 
   freea (null);
+  if (compressed_data != NULL)
+    free (compressed_data);
+  if (trans_offsets != NULL)
+    free (trans_offsets);
+  if (owners != NULL)
+    free (owners);
+  if (order != NULL)
+    free (order);
   for (j = 0; j < mlp->nitems; j++)
-    free (msgctid_arr[j]);
+    {
+      free (msgctid_arr[j]);
+      if (msgstr_arr[j] != NULL)
+        free (msgstr_arr[j]);
+    }
   free (sysdep_msg_arr);
   free (msg_arr);
+  free (msgstr_arr);
   free (msgctid_arr);
 }
 
 
+/* Write IMAGE to FILE_NAME, or to stdout if DOMAIN_NAME is "-", and free
+   its contents.  Return 0 if ok, nonzero on error.  */
+static int
+write_image (struct mo_image *image,
+             const char *domain_name, const char *file_name)
+{
+  FILE *output_file;
+  struct stat statbuf;
+  char *temp_file_name;
+
+  if (strcmp (domain_name, "-") == 0)
+    {
+      output_file = stdout;
+      SET_BINARY (fileno (output_file));
+      temp_file_name = NULL;
+    }
+  else
+    {
+      /* Write a regular file under a temporary name and rename it, so
+         that a program that loads the file while it is being written
+         sees either the old or the new contents.  Other files, such as
+         /dev/null or symbolic links, are written in place.  */
+      if (lstat (file_name, &statbuf) < 0
+          ? errno == ENOENT
+          : S_ISREG (statbuf.st_mode))
+        temp_file_name =
+          xasprintf ("%s.%ld.tmp", file_name, (long) getpid ());
+      else
+        temp_file_name = NULL;
+
+      output_file =
+        fopen (temp_file_name != NULL ? temp_file_name : file_name, "wb");
+      if (output_file == NULL)
+        {
+          error (0, errno, _("error while opening \"%s\" for writing"),
+                 file_name);
+          free (temp_file_name);
+          free (image->data);
+          return 1;
+        }
+    }
+
+  fwrite (image->data, image->length, 1, output_file);
+  free (image->data);
+
+  if (temp_file_name != NULL && fflush (output_file) == 0)
+    fsync (fileno (output_file));
+
+  /* Make sure nothing went wrong.  */
+  if (fwriteerror (output_file))
+    {
+      int saved_errno = errno;
+
+      if (temp_file_name != NULL)
+        unlink (temp_file_name);
+      error (EXIT_FAILURE, saved_errno,
+             _("error while writing \"%s\" file"), file_name);
+    }
+
+  if (temp_file_name != NULL)
+    {
+      int ret = 0;
+
+      /* Keep the permissions of the file being replaced.  */
+      if (lstat (file_name, &statbuf) == 0)
+        chmod (temp_file_name, statbuf.st_mode & 07777);
+
+      if (rename (temp_file_name, file_name) < 0)
+        {
+          error (0, errno, _("cannot rename \"%s\" to \"%s\""),
+                 temp_file_name, file_name);
+          unlink (temp_file_name);
+          ret = 1;
+        }
+      free (temp_file_name);
+      return ret;
+    }
+
+  return 0;
+}
+
+
 int
 msgdomain_write_mo (message_list_ty *mlp,
                     const char *domain_name,
                     const char *file_name)
 {
-  FILE *output_file;
-
   /* If no entry for this domain don't even create the file.  */
   if (mlp->nitems != 0)
     {
-      if (strcmp (domain_name, "-") == 0)
+      struct mo_image image;
+
+      image.data = NULL;
+      image.length = 0;
+      image.allocated = 0;
+      write_table (&image, mlp);
+
+      return write_image (&image, domain_name, file_name);
+    }
+
+  return 0;
+}
+
+
+/* The catalogs collected for the bundle.  */
+struct bundle_member_image
+{
+  char *name;
+  struct mo_image image;
+};
+static struct bundle_member_image *bundle_members;
+static size_t bundle_nmembers;
+static size_t bundle_nmembers_max;
+
+/* Add an empty member named MEMBER_NAME to the bundle, and return its
+   image.  */
+static struct mo_image *
+bundle_new_member (const char *member_name)
+{
+  struct bundle_member_image *member;
+
+  if (bundle_nmembers == bundle_nmembers_max)
+    {
+      bundle_nmembers_max = 2 * bundle_nmembers_max + 16;
+      bundle_members =
+        (struct bundle_member_image *)
+        xrealloc (bundle_members,
+                  bundle_nmembers_max * sizeof (struct bundle_member_image));
+    }
+  member = &bundle_members[bundle_nmembers++];
+  member->name = xstrdup (member_name);
+  member->image.data = NULL;
+  member->image.length = 0;
+  member->image.allocated = 0;
+  return &member->image;
+}
+
+/* Forget the members of the bundle.  */
+static void
+bundle_free_members (void)
+{
+  size_t i;
+
+  for (i = 0; i < bundle_nmembers; i++)
+    {
+      free (bundle_members[i].image.data);
+      free (bundle_members[i].name);
+    }
+  free (bundle_members);
+  bundle_members = NULL;
+  bundle_nmembers = 0;
+  bundle_nmembers_max = 0;
+}
+
+void
+bundle_add_mo (message_list_ty *mlp, const char *member_name)
+{
+  /* As with msgdomain_write_mo, an empty catalog is not stored.  */
+  if (mlp->nitems == 0)
+    return;
+
+  write_table (bundle_new_member (member_name), mlp);
+}
+
+/* The members are passed between processes of the same program on the same
+   machine, so their sizes are written in the native format.  */
+
+int
+bundle_write_members (FILE *fp)
+{
+  size_t i;
+
+  fwrite (&bundle_nmembers, sizeof (size_t), 1, fp);
+  for (i = 0; i < bundle_nmembers; i++)
+    {
+      size_t name_length = strlen (bundle_members[i].name);
+      const struct mo_image *image = &bundle_members[i].image;
+
+      fwrite (&name_length, sizeof (size_t), 1, fp);
+      fwrite (bundle_members[i].name, 1, name_length, fp);
+      fwrite (&image->length, sizeof (size_t), 1, fp);
+      fwrite (image->data, 1, image->length, fp);
+    }
+  bundle_free_members ();
+
+  return fflush (fp) != 0 || ferror (fp);
+}
+
+int
+bundle_read_members (FILE *fp)
+{
+  size_t nmembers;
+  size_t i;
+
+  if (fread (&nmembers, sizeof (size_t), 1, fp) != 1)
+    return 1;
+  for (i = 0; i < nmembers; i++)
+    {
+      size_t name_length;
+      size_t length;
+      char *name;
+      struct mo_image *image;
+
+      if (fread (&name_length, sizeof (size_t), 1, fp) != 1)
+        return 1;
+      name = XNMALLOC (name_length + 1, char);
+      if (fread (name, 1, name_length, fp) != name_length)
         {
-          output_file = stdout;
-          SET_BINARY (fileno (output_file));
+          free (name);
+          return 1;
         }
-      else
+      name[name_length] = '\0';
+      image = bundle_new_member (name);
+      free (name);
+
+      if (fread (&length, sizeof (size_t), 1, fp) != 1)
+        return 1;
+      image->data = XNMALLOC (length, char);
+      image->allocated = length;
+      if (fread (image->data, 1, length, fp) != length)
+        return 1;
+      image->length = length;
+    }
+  return 0;
+}
+
+static int
+compare_bundle_member (const void *pval1, const void *pval2)
+{
+  return strcmp (((const struct bundle_member_image *) pval1)->name,
+                 ((const struct bundle_member_image *) pval2)->name);
+}
+
+int
+bundle_write (const char *file_name)
+{
+  struct mo_image image;
+  struct bundle_file_header header;
+  size_t names_offset;
+  size_t names_length;
+  size_t offset;
+  size_t i;
+  static const char null[8];
+
+  /* Libintl finds the members by binary search.  */
+  qsort (bundle_members, bundle_nmembers, sizeof (struct bundle_member_image),
+         compare_bundle_member);
+  for (i = 1; i < bundle_nmembers; i++)
+    if (strcmp (bundle_members[i - 1].name, bundle_members[i].name) == 0)
+      {
+        error (0, 0, _("more than one input file for bundle member \"%s\""),
+               bundle_members[i].name);
+        return 1;
+      }
+
+  /* Compute the layout: the header, the table of members, their names,
+     and the .mo files, each at an offset that is a multiple of 8.  */
+  names_offset =
+    sizeof (struct bundle_file_header)
+    + bundle_nmembers * sizeof (struct bundle_member);
+  names_length = 0;
+  for (i = 0; i < bundle_nmembers; i++)
+    names_length += strlen (bundle_members[i].name) + 1;
+  offset = roundup (names_offset + names_length, 8);
+  for (i = 0; i < bundle_nmembers; i++)
+    offset = roundup (offset + bundle_members[i].image.length, 8);
+  if (offset > (nls_uint32) ~0)
+    {
+      error (0, 0, _("bundle \"%s\" would be larger than 4 GB"), file_name);
+      return 1;
+    }
+
+  image.data = XNMALLOC (offset, char);
+  image.length = 0;
+  image.allocated = offset;
+
+  header.magic = _MAGIC_BUNDLE;
+  header.revision = BUNDLE_REVISION_NUMBER;
+  header.nmembers = bundle_nmembers;
+  header.members_offset = sizeof (struct bundle_file_header);
+  if (byteswap)
+    {
+      BSWAP32 (header.magic);
+      BSWAP32 (header.revision);
+      BSWAP32 (header.nmembers);
+      BSWAP32 (header.members_offset);
+    }
+  image_append (&image, &header, sizeof (header));
+
+  offset = roundup (names_offset + names_length, 8);
+  names_length = 0;
+  for (i = 0; i < bundle_nmembers; i++)
+    {
+      struct bundle_member member;
+
+      member.name_offset = names_offset + names_length;
+      member.length = bundle_members[i].image.length;
+      member.offset = offset;
+      if (byteswap)
         {
-          output_file = fopen (file_name, "wb");
-          if (output_file == NULL)
-            {
-              error (0, errno, _("error while opening \"%s\" for writing"),
-                     file_name);
-              return 1;
-            }
+          BSWAP32 (member.name_offset);
+          BSWAP32 (member.length);
+          BSWAP32 (member.offset);
         }
+      image_append (&image, &member, sizeof (member));
+      names_length += strlen (bundle_members[i].name) + 1;
+      offset = roundup (offset + bundle_members[i].image.length, 8);
+    }
 
-      if (output_file != NULL)
-        {
-          write_table (output_file, mlp);
+  for (i = 0; i < bundle_nmembers; i++)
+    image_append (&image, bundle_members[i].name,
+                  strlen (bundle_members[i].name) + 1);
 
-          /* Make sure nothing went wrong.  */
-          if (fwriteerror (output_file))
-            error (EXIT_FAILURE, errno, _("error while writing \"%s\" file"),
-                   file_name);
-        }
+  for (i = 0; i < bundle_nmembers; i++)
+    {
+      struct mo_image *member_image = &bundle_members[i].image;
+
+      image_append (&image, null, roundup (image.length, 8) - image.length);
+      image_append (&image, member_image->data, member_image->length);
     }
+  image_append (&image, null, roundup (image.length, 8) - image.length);
 
-  return 0;
+  bundle_free_members ();
+
+  return write_image (&image, file_name, file_name);
 }
@@ -21,6 +21,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 #include "message.h"
 
@@ -33,6 +34,24 @@ extern bool byteswap;
 /* True if no hash table in .mo is wanted.  */
 extern bool no_hash_table;
 
+/* True if each original string shall be immediately followed by its
+   translation in .mo file.  */
+extern bool interleave_strings;
+
+/* True if a perfect hash table in .mo is wanted.  */
+extern bool perfect_hash_table;
+
+/* True if equal strings, and strings that are the end of another string,
+   shall be stored only once in .mo file.  */
+extern bool share_strings;
+
+/* True if the translated strings shall be compressed in .mo file.  */
+extern bool compress_strings;
+
+/* True if the system dependent strings shall be expanded for this platform
+   in .mo file.  */
+extern bool expand_sysdep_strings;
+
 /* Write a GNU mo file.  mlp is a list containing the messages to be output.
    domain_name is the domain name, file_name is the desired file name.
    Return 0 if ok, nonzero on error.  */
@@ -41,4 +60,26 @@ extern int
                            const char *domain_name,
                            const char *file_name);
 
+/* Compile the messages in mlp and keep the result, for inclusion in a
+   bundle under the name member_name.  */
+extern void
+       bundle_add_mo (message_list_ty *mlp, const char *member_name);
+
+/* Write a bundle of the catalogs given to bundle_add_mo so far to
+   file_name, and forget them.  Return 0 if ok, nonzero on error.  */
+extern int
+       bundle_write (const char *file_name);
+
+/* Write the catalogs given to bundle_add_mo so far to fp, in a form that
+   only bundle_read_members understands, and forget them.  This passes the
+   catalogs compiled in a child process to its parent.  Return 0 if ok,
+   nonzero on error.  */
+extern int
+       bundle_write_members (FILE *fp);
+
+/* Add the catalogs that bundle_write_members wrote to fp, as if they had
+   been given to bundle_add_mo.  Return 0 if ok, nonzero on error.  */
+extern int
+       bundle_read_members (FILE *fp);
+
 #endif /* _WRITE_MO_H */
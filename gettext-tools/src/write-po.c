@@ -37,12 +37,12 @@
 
 #include "c-ctype.h"
 #include "po-charset.h"
+#include "unistr.h"
 #include "format.h"
 #include "unilbrk.h"
 #include "msgl-ascii.h"
 #include "write-catalog.h"
 #include "xalloc.h"
-#include "xmalloca.h"
 #include "c-strstr.h"
 #include "ostream.h"
 #ifdef GETTEXTDATADIR
@@ -613,6 +613,58 @@ memset_small (void *dst, char c, size_t n)
 }
 
 
+#if HAVE_ICONV
+/* Return the length of the multibyte character that starts at P and ends
+   before P_END, in the encoding CANON_CHARSET that CONV converts from.
+   ASCII characters in an ASCII compatible encoding and all characters in
+   UTF-8 are recognized without calling iconv().  Return (size_t)(-1), with
+   errno set, if there is no valid character at P.  */
+static size_t
+multibyte_char_length (iconv_t conv, const char *canon_charset,
+                       bool ascii_compatible,
+                       const char *p, const char *p_end)
+{
+  if ((unsigned char) *p < 0x80 && ascii_compatible)
+    return 1;
+  else if (canon_charset == po_charset_utf8)
+    {
+      ucs4_t uc;
+      int n = u8_mbtoucr (&uc, (const unsigned char *) p, p_end - p);
+
+      if (n >= 0)
+        return n;
+      errno = (n == -2 ? EINVAL : EILSEQ);
+      return (size_t)(-1);
+    }
+  else
+    {
+      char scratchbuf[64];
+      const char *inptr = p;
+      size_t insize;
+      char *outptr = &scratchbuf[0];
+      size_t outsize = sizeof (scratchbuf);
+      size_t res;
+
+      res = (size_t)(-1);
+      for (insize = 1; inptr + insize <= p_end; insize++)
+        {
+          res = iconv (conv,
+                       (ICONV_CONST char **) &inptr, &insize,
+                       &outptr, &outsize);
+          if (!(res == (size_t)(-1) && errno == EINVAL))
+            break;
+          /* We expect that no input bytes have been consumed so far.  */
+          if (inptr != p)
+            abort ();
+        }
+      if (res == (size_t)(-1))
+        return res;
+      return inptr - p;
+    }
+}
+#endif
+
+
 static void
 wrap (const message_ty *mp, ostream_t stream,
       const char *line_prefix, int extra_indent, const char *css_class,
@@ -628,6 +680,7 @@ wrap (const message_ty *mp, ostream_t stream,
 #if HAVE_ICONV
   const char *envval;
   iconv_t conv;
+  bool ascii_compatible;
 #endif
   bool weird_cjk;
 
@@ -672,7 +725,10 @@ wrap (const message_ty *mp, ostream_t stream,
       conv = iconv_open ("UTF-8", canon_charset);
 
   if (conv != (iconv_t)(-1))
-    weird_cjk = false;
+    {
+      weird_cjk = false;
+      ascii_compatible = po_charset_ascii_compatible (canon_charset);
+    }
   else
 #endif
     if (canon_charset == NULL)
@@ -756,6 +812,7 @@ wrap (const message_ty *mp, ostream_t stream,
       char *overrides;
       char *attributes;
       char *linebreaks;
+      bool portion_ascii;
       char *pp;
       char *op;
       char *ap;
@@ -785,27 +842,11 @@ wrap (const message_ty *mp, ostream_t stream,
                      interpret the second byte of a multi-byte character as
                      ASCII.  This is needed for the BIG5, BIG5-HKSCS, GBK,
                      GB18030, SHIFT_JIS, JOHAB encodings.  */
-                  char scratchbuf[64];
-                  const char *inptr = ep;
-                  size_t insize;
-                  char *outptr = &scratchbuf[0];
-                  size_t outsize = sizeof (scratchbuf);
-                  size_t res;
-
-                  res = (size_t)(-1);
-                  for (insize = 1; inptr + insize <= es; insize++)
-                    {
-                      res = iconv (conv,
-                                   (ICONV_CONST char **) &inptr, &insize,
-                                   &outptr, &outsize);
-                      if (!(res == (size_t)(-1) && errno == EINVAL))
-                        break;
-                      /* We expect that no input bytes have been consumed
-                         so far.  */
-                      if (inptr != ep)
-                        abort ();
-                    }
-                  if (res == (size_t)(-1))
+                  size_t insize =
+                    multibyte_char_length (conv, canon_charset,
+                                           ascii_compatible, ep, es);
+
+                  if (insize == (size_t)(-1))
                     {
                       if (errno == EILSEQ)
                         {
@@ -825,7 +866,6 @@ wrap (const message_ty *mp, ostream_t stream,
                       else
                         abort ();
                     }
-                  insize = inptr - ep;
                   portion_len += insize;
                   ep += insize - 1;
                 }
@@ -849,6 +889,7 @@ wrap (const message_ty *mp, ostream_t stream,
       portion = XNMALLOC (portion_len, char);
       overrides = XNMALLOC (portion_len, char);
       attributes = XNMALLOC (portion_len, char);
+      portion_ascii = true;
       for (ep = s, pp = portion, op = overrides, ap = attributes; ep < es; ep++)
         {
           char c = *ep;
@@ -916,6 +957,8 @@ internationalized messages should not contain the '\\%c' escape sequence"),
             }
           else
             {
+              if (!((unsigned char) c >= 0x20 && (unsigned char) c < 0x7f))
+                portion_ascii = false;
 #if HAVE_ICONV
               if (conv != (iconv_t)(-1))
                 {
@@ -923,27 +966,11 @@ internationalized messages should not contain the '\\%c' escape sequence"),
                      interpret the second byte of a multi-byte character as
                      ASCII.  This is needed for the BIG5, BIG5-HKSCS, GBK,
                      GB18030, SHIFT_JIS, JOHAB encodings.  */
-                  char scratchbuf[64];
-                  const char *inptr = ep;
-                  size_t insize;
-                  char *outptr = &scratchbuf[0];
-                  size_t outsize = sizeof (scratchbuf);
-                  size_t res;
-
-                  res = (size_t)(-1);
-                  for (insize = 1; inptr + insize <= es; insize++)
-                    {
-                      res = iconv (conv,
-                                   (ICONV_CONST char **) &inptr, &insize,
-                                   &outptr, &outsize);
-                      if (!(res == (size_t)(-1) && errno == EINVAL))
-                        break;
-                      /* We expect that no input bytes have been consumed
-                         so far.  */
-                      if (inptr != ep)
-                        abort ();
-                    }
-                  if (res == (size_t)(-1))
+                  size_t insize =
+                    multibyte_char_length (conv, canon_charset,
+                                           ascii_compatible, ep, es);
+
+                  if (insize == (size_t)(-1))
                     {
                       if (errno == EILSEQ)
                         {
@@ -954,7 +981,6 @@ internationalized messages should not contain the '\\%c' escape sequence"),
                       else
                         abort ();
                     }
-                  insize = inptr - ep;
                   memcpy_small (pp, ep, insize);
                   pp += insize;
                   *op = brk;
@@ -1032,9 +1058,14 @@ internationalized messages should not contain the '\\%c' escape sequence"),
       /* Adjust for indentation of subsequent lines.  */
       startcol -= startcol_after_break;
 
-      /* Do line breaking on the portion.  */
-      ulc_width_linebreaks (portion, portion_len, width, startcol, 0,
-                            overrides, canon_charset, linebreaks);
+      /* Do line breaking on the portion.  A portion of printable ASCII
+         characters that fits in the line needs no line breaks.  */
+      if (portion_ascii && startcol <= width
+          && portion_len <= (size_t) (width - startcol))
+        memset (linebreaks, UC_BREAK_PROHIBITED, portion_len);
+      else
+        ulc_width_linebreaks (portion, portion_len, width, startcol, 0,
+                              overrides, canon_charset, linebreaks);
 
       /* If this is the first line, and we are not using the indented
          style, and the line would wrap, then use an empty first line
@@ -1201,7 +1232,18 @@ internationalized messages should not contain the '\\%c' escape sequence"),
                     currattr |= ATTR_ESCAPE_SEQUENCE;
                   }
               }
-            ostream_write_mem (stream, &portion[i], 1);
+            /* Print the run of characters up to the next line break or
+               change of attributes at once.  */
+            {
+              size_t j;
+
+              for (j = i + 1; j < portion_len; j++)
+                if (linebreaks[j] == UC_BREAK_POSSIBLE
+                    || attributes[j] != currattr)
+                  break;
+              ostream_write_mem (stream, &portion[i], j - i);
+              i = j - 1;
+            }
           }
 
         /* Change currattr so that it becomes 0.  */
@@ -1509,100 +1551,329 @@ different from yours. Consider using a pure ASCII msgid instead.\n\
 }
 
 
+/* Print a domain directive.  */
+static void
+print_domain_directive (ostream_t stream, const char *domain)
+{
+  begin_css_class (stream, class_keyword);
+  ostream_write_str (stream, "domain");
+  end_css_class (stream, class_keyword);
+  ostream_write_str (stream, " ");
+  begin_css_class (stream, class_string);
+  ostream_write_str (stream, "\"");
+  begin_css_class (stream, class_text);
+  ostream_write_str (stream, domain);
+  end_css_class (stream, class_text);
+  ostream_write_str (stream, "\"");
+  end_css_class (stream, class_string);
+  ostream_write_str (stream, "\n");
+}
+
+
+/* Extract the charset name from a header entry's msgstr.  Return it in
+   freshly allocated memory, or NULL if there is none.  */
+static char *
+header_charset (const char *header)
+{
+  const char *charsetstr = c_strstr (header, "charset=");
+
+  if (charsetstr != NULL)
+    {
+      size_t len;
+      char *charset;
+
+      charsetstr += strlen ("charset=");
+      len = strcspn (charsetstr, " \t\n");
+      charset = XNMALLOC (len + 1, char);
+      memcpy (charset, charsetstr, len);
+      charset[len] = '\0';
+
+      /* Treat the dummy default value as if it were absent.  */
+      if (strcmp (charset, "CHARSET") == 0)
+        {
+          free (charset);
+          charset = NULL;
+        }
+      return charset;
+    }
+  else
+    return NULL;
+}
+
+
+/* Write out the messages of the domain MDP, preceded by a domain directive
+   if WITH_DIRECTIVE.  *BLANK_LINEP tells whether a blank line is needed
+   before the next message.  */
+static void
+msgdomain_print_po (msgdomain_ty *mdp, bool with_directive,
+                    ostream_t stream, size_t page_width, bool debug,
+                    bool *blank_linep)
+{
+  message_list_ty *mlp = mdp->messages;
+  bool blank_line = *blank_linep;
+  const char *header;
+  const char *charset;
+  char *allocated_charset;
+  size_t j;
+
+  if (with_directive)
+    {
+      if (blank_line)
+        print_blank_line (stream);
+      print_domain_directive (stream, mdp->domain);
+      blank_line = true;
+    }
+
+  /* Search the header entry.  */
+  header = NULL;
+  for (j = 0; j < mlp->nitems; ++j)
+    if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
+      {
+        header = mlp->item[j]->msgstr;
+        break;
+      }
+
+  /* Extract the charset name.  */
+  allocated_charset = (header != NULL ? header_charset (header) : NULL);
+  charset = (allocated_charset != NULL ? allocated_charset : "ASCII");
+
+  /* Write out each of the messages for this domain.  */
+  for (j = 0; j < mlp->nitems; ++j)
+    if (!mlp->item[j]->obsolete)
+      {
+        message_print (mlp->item[j], stream, charset, page_width,
+                       blank_line, debug);
+        blank_line = true;
+      }
+
+  /* Write out each of the obsolete messages for this domain.  */
+  for (j = 0; j < mlp->nitems; ++j)
+    if (mlp->item[j]->obsolete)
+      {
+        message_print_obsolete (mlp->item[j], stream, charset, page_width,
+                                blank_line);
+        blank_line = true;
+      }
+
+  if (allocated_charset != NULL)
+    free (allocated_charset);
+
+  *blank_linep = blank_line;
+}
+
+
 static void
 msgdomain_list_print_po (msgdomain_list_ty *mdlp, ostream_t stream,
                          size_t page_width, bool debug)
 {
-  size_t j, k;
+  size_t k;
   bool blank_line;
 
   /* Write out the messages for each domain.  */
   blank_line = false;
   for (k = 0; k < mdlp->nitems; k++)
+    /* If the first domain is the default, don't bother emitting
+       the domain name, because it is the default.  */
+    msgdomain_print_po (mdlp->item[k],
+                        !(k == 0
+                          && strcmp (mdlp->item[k]->domain,
+                                     MESSAGE_DOMAIN_DEFAULT) == 0),
+                        stream, page_width, debug, &blank_line);
+}
+
+
+/* ============== Output of a PO file one message at a time. ============== */
+
+
+struct po_writer
+{
+  ostream_t stream;
+  size_t page_width;
+  bool debug;
+
+  /* The domain of the first message, or NULL before the first message.
+     The messages of this domain are written as they come.  */
+  char *domain;
+
+  /* Whether the header entry of this domain has been seen.  */
+  bool seen_header;
+
+  /* The charset of this domain, as declared in its header entry, or
+     NULL.  */
+  char *charset;
+
+  /* The messages of this domain that precede its header entry.  They are
+     held back until the header entry tells their charset, or until the end
+     of the domain, when there is no header entry.  */
+  message_list_ty *pending;
+
+  /* Whether a blank line is needed before the next message.  */
+  bool blank_line;
+
+  /* The obsolete messages of this domain.  They are written after the
+     other messages of the domain, like output_format_po does.  */
+  message_list_ty *obsolete;
+
+  /* The messages of the other domains.  They are written at the end,
+     grouped by domain, so that each domain occurs only once in the output,
+     like output_format_po does.  */
+  msgdomain_list_ty *other_domains;
+};
+
+
+po_writer_ty *
+po_writer_create (ostream_t stream, size_t page_width, bool debug)
+{
+  po_writer_ty *writer = XMALLOC (po_writer_ty);
+
+  writer->stream = stream;
+  writer->page_width = page_width;
+  writer->debug = debug;
+  writer->domain = NULL;
+  writer->seen_header = false;
+  writer->charset = NULL;
+  writer->pending = message_list_alloc (false);
+  writer->blank_line = false;
+  writer->obsolete = message_list_alloc (false);
+  writer->other_domains = msgdomain_list_alloc (false);
+  return writer;
+}
+
+
+/* Write out the non-obsolete message MP of the first domain, and free it.  */
+static void
+po_writer_print (po_writer_ty *writer, message_ty *mp)
+{
+  message_print (mp, writer->stream,
+                 writer->charset != NULL ? writer->charset : "ASCII",
+                 writer->page_width, writer->blank_line, writer->debug);
+  writer->blank_line = true;
+  message_free (mp);
+}
+
+
+/* Write out the messages held back so far.  */
+static void
+po_writer_flush_pending (po_writer_ty *writer)
+{
+  message_list_ty *mlp = writer->pending;
+  size_t j;
+
+  for (j = 0; j < mlp->nitems; j++)
+    po_writer_print (writer, mlp->item[j]);
+  mlp->nitems = 0;
+}
+
+
+/* Write out the messages of the first domain that are still held back, and
+   its obsolete messages.  */
+static void
+po_writer_finish_domain (po_writer_ty *writer)
+{
+  message_list_ty *mlp = writer->obsolete;
+  size_t j;
+
+  po_writer_flush_pending (writer);
+
+  for (j = 0; j < mlp->nitems; j++)
     {
-      message_list_ty *mlp;
-      const char *header;
-      const char *charset;
-      char *allocated_charset;
+      message_print_obsolete (mlp->item[j], writer->stream,
+                              writer->charset != NULL
+                              ? writer->charset
+                              : "ASCII",
+                              writer->page_width, writer->blank_line);
+      writer->blank_line = true;
+      message_free (mlp->item[j]);
+    }
+  mlp->nitems = 0;
+}
+
 
+/* Return the list of messages of DOMAIN that are written at the end, or
+   NULL if DOMAIN is the first domain.  */
+static message_list_ty *
+po_writer_sublist (po_writer_ty *writer, const char *domain)
+{
+  if (writer->domain == NULL)
+    {
       /* If the first domain is the default, don't bother emitting
          the domain name, because it is the default.  */
-      if (!(k == 0
-            && strcmp (mdlp->item[k]->domain, MESSAGE_DOMAIN_DEFAULT) == 0))
+      if (strcmp (domain, MESSAGE_DOMAIN_DEFAULT) != 0)
         {
-          if (blank_line)
-            print_blank_line (stream);
-          begin_css_class (stream, class_keyword);
-          ostream_write_str (stream, "domain");
-          end_css_class (stream, class_keyword);
-          ostream_write_str (stream, " ");
-          begin_css_class (stream, class_string);
-          ostream_write_str (stream, "\"");
-          begin_css_class (stream, class_text);
-          ostream_write_str (stream, mdlp->item[k]->domain);
-          end_css_class (stream, class_text);
-          ostream_write_str (stream, "\"");
-          end_css_class (stream, class_string);
-          ostream_write_str (stream, "\n");
-          blank_line = true;
+          print_domain_directive (writer->stream, domain);
+          writer->blank_line = true;
         }
+      writer->domain = xstrdup (domain);
+    }
+  else if (strcmp (domain, writer->domain) != 0)
+    return msgdomain_list_sublist (writer->other_domains, domain, true);
+  return NULL;
+}
 
-      mlp = mdlp->item[k]->messages;
 
-      /* Search the header entry.  */
-      header = NULL;
-      for (j = 0; j < mlp->nitems; ++j)
-        if (is_header (mlp->item[j]) && !mlp->item[j]->obsolete)
-          {
-            header = mlp->item[j]->msgstr;
-            break;
-          }
+void
+po_writer_domain (po_writer_ty *writer, const char *domain)
+{
+  po_writer_sublist (writer, domain);
+}
 
-      /* Extract the charset name.  */
-      charset = "ASCII";
-      allocated_charset = NULL;
-      if (header != NULL)
-        {
-          const char *charsetstr = c_strstr (header, "charset=");
 
-          if (charsetstr != NULL)
-            {
-              size_t len;
+void
+po_writer_message (po_writer_ty *writer, const char *domain, message_ty *mp)
+{
+  message_list_ty *mlp = po_writer_sublist (writer, domain);
 
-              charsetstr += strlen ("charset=");
-              len = strcspn (charsetstr, " \t\n");
-              allocated_charset = (char *) xmalloca (len + 1);
-              memcpy (allocated_charset, charsetstr, len);
-              allocated_charset[len] = '\0';
-              charset = allocated_charset;
+  if (mlp != NULL)
+    {
+      /* Keep it for the end.  */
+      message_list_append (mlp, mp);
+      return;
+    }
 
-              /* Treat the dummy default value as if it were absent.  */
-              if (strcmp (charset, "CHARSET") == 0)
-                charset = "ASCII";
-            }
-        }
+  if (mp->obsolete)
+    /* Keep it for later.  */
+    message_list_append (writer->obsolete, mp);
+  else if (writer->seen_header)
+    po_writer_print (writer, mp);
+  else if (is_header (mp))
+    {
+      /* Now the charset of the messages is known.  */
+      writer->seen_header = true;
+      writer->charset = header_charset (mp->msgstr);
+      po_writer_flush_pending (writer);
+      po_writer_print (writer, mp);
+    }
+  else
+    /* Keep it until the charset is known.  */
+    message_list_append (writer->pending, mp);
+}
 
-      /* Write out each of the messages for this domain.  */
-      for (j = 0; j < mlp->nitems; ++j)
-        if (!mlp->item[j]->obsolete)
-          {
-            message_print (mlp->item[j], stream, charset, page_width,
-                           blank_line, debug);
-            blank_line = true;
-          }
 
-      /* Write out each of the obsolete messages for this domain.  */
-      for (j = 0; j < mlp->nitems; ++j)
-        if (mlp->item[j]->obsolete)
-          {
-            message_print_obsolete (mlp->item[j], stream, charset, page_width,
-                                    blank_line);
-            blank_line = true;
-          }
+void
+po_writer_free (po_writer_ty *writer)
+{
+  msgdomain_list_ty *mdlp = writer->other_domains;
+  size_t k;
 
-      if (allocated_charset != NULL)
-        freea (allocated_charset);
-    }
+  po_writer_finish_domain (writer);
+  message_list_free (writer->pending, 1);
+  message_list_free (writer->obsolete, 1);
+
+  /* The list starts with the default domain.  Write it only if some of its
+     messages came after those of another domain.  The other domains are
+     written even when they have no message, like output_format_po does.  */
+  for (k = 0; k < mdlp->nitems; k++)
+    if (k > 0 || mdlp->item[k]->messages->nitems > 0)
+      msgdomain_print_po (mdlp->item[k], true, writer->stream,
+                          writer->page_width, writer->debug,
+                          &writer->blank_line);
+  msgdomain_list_free (mdlp);
+
+  if (writer->domain != NULL)
+    free (writer->domain);
+  if (writer->charset != NULL)
+    free (writer->charset);
+  free (writer);
 }
 
 
@@ -75,6 +75,31 @@ extern void
 /* --add-location argument handling.  Return an error indicator.  */
 extern bool handle_filepos_comment_option (const char *option);
 
+/* Output of a PO file one message at a time, for programs that process
+   the messages of a catalog as they are read.  The result is the same as
+   output_format_po.print would produce for the same messages, except that
+   messages of the default domain that come after those of another domain
+   are written after them, with a domain directive.  Only the messages of
+   the first domain are written as they come; the others are held back
+   until the end.  Messages that precede the header entry of the first
+   domain are held back until it comes, because its charset determines how
+   they are written.  */
+typedef struct po_writer po_writer_ty;
+extern po_writer_ty *
+       po_writer_create (ostream_t stream, size_t page_width, bool debug);
+/* Write MP, that belongs to DOMAIN, and take ownership of it.  Obsolete
+   messages are written only at the end.  */
+extern void
+       po_writer_message (po_writer_ty *writer, const char *domain,
+                          message_ty *mp);
+/* Take note of DOMAIN, although none of its messages are written, so that
+   the domain directive is written nevertheless.  */
+extern void
+       po_writer_domain (po_writer_ty *writer, const char *domain);
+/* Write the remaining messages and free WRITER.  */
+extern void
+       po_writer_free (po_writer_ty *writer);
+
 
 /* Describes a PO file in .po syntax.  */
 extern DLL_VARIABLE const struct catalog_output_format output_format_po;
@@ -156,6 +156,7 @@ extract (FILE *fp,
 
   pop = default_catalog_reader_alloc (&extract_methods);
   pop->handle_comments = true;
+  pop->handle_filepos_comments = true;
   pop->allow_domain_directives = false;
   pop->allow_duplicates = false;
   pop->allow_duplicates_if_same_msgstr = true;
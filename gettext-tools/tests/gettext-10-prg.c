@@ -0,0 +1,110 @@
+/* Test program, used by the gettext-10 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+int
+main (int argc, char *argv[])
+{
+  char *old;
+  char *s;
+  int n;
+  int result = 0;
+
+  /* Clean up environment.  */
+  unsetenv ("LANGUAGE");
+  unsetenv ("LC_ALL");
+  unsetenv ("LC_MESSAGES");
+  unsetenv ("LC_CTYPE");
+  unsetenv ("LANG");
+  unsetenv ("OUTPUT_CHARSET");
+
+  xsetenv ("LC_ALL", argv[1], 1);
+  setlocale (LC_ALL, "");
+  bindtextdomain ("reload", "gt-10");
+  bindtextdomain ("other", "gt-10");
+
+  old = dgettext ("reload", "cheese");
+  if (strcmp (old, "fromage"))
+    {
+      fprintf (stderr, "call 1 returned: %s\n", old);
+      result = 1;
+    }
+
+  /* Nothing has changed yet.  */
+  n = textdomain_reload ("reload");
+  if (n != 0)
+    {
+      fprintf (stderr, "reload of unchanged domain returned: %d\n", n);
+      result = 1;
+    }
+
+  s = dgettext ("other", "cheese");
+  if (strcmp (s, "fromage"))
+    {
+      fprintf (stderr, "call 2 returned: %s\n", s);
+      result = 1;
+    }
+
+  /* Replace the catalog atomically, as a hot patch would do.  */
+  if (rename ("gt-10/reload-new.mo", "gt-10/fr/LC_MESSAGES/reload.mo") != 0)
+    {
+      perror ("rename");
+      return 1;
+    }
+
+  n = textdomain_reload ("reload");
+  if (n != 1)
+    {
+      fprintf (stderr, "reload of replaced domain returned: %d\n", n);
+      result = 1;
+    }
+
+  s = dgettext ("reload", "cheese");
+  if (strcmp (s, "fromage affine"))
+    {
+      fprintf (stderr, "call 3 returned: %s\n", s);
+      result = 1;
+    }
+
+  /* Strings returned before the reload must still be usable.  */
+  if (strcmp (old, "fromage"))
+    {
+      fprintf (stderr, "old translation changed to: %s\n", old);
+      result = 1;
+    }
+
+  s = dgettext ("other", "cheese");
+  if (strcmp (s, "fromage"))
+    {
+      fprintf (stderr, "call 4 returned: %s\n", s);
+      result = 1;
+    }
+
+  return result;
+}
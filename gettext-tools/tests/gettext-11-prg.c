@@ -0,0 +1,105 @@
+/* Test program, used by the gettext-11 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+
+int
+main (int argc, char *argv[])
+{
+  struct textdomain_cache_info info;
+  char *s;
+  int i;
+  int result = 0;
+
+  /* Clean up environment.  */
+  unsetenv ("LANGUAGE");
+  unsetenv ("LC_ALL");
+  unsetenv ("LC_MESSAGES");
+  unsetenv ("LC_CTYPE");
+  unsetenv ("LANG");
+  unsetenv ("OUTPUT_CHARSET");
+
+  xsetenv ("LC_ALL", argv[1], 1);
+  setlocale (LC_ALL, "");
+  textdomain ("cache");
+  bindtextdomain ("cache", "gt-11");
+
+  if (textdomain_cache_limit (1) != 0)
+    {
+      fprintf (stderr, "default limit is not 0\n");
+      result = 1;
+    }
+
+  /* Alternate between two messages, so that each lookup evicts the
+     other one.  */
+  for (i = 0; i < 10; i++)
+    {
+      s = gettext ("cheese");
+      if (strcmp (s, "fromage"))
+	{
+	  fprintf (stderr, "call 1 returned: %s\n", s);
+	  result = 1;
+	}
+
+      s = ngettext ("file", "files", i);
+      if (strcmp (s, i > 1 ? "fichiers" : "fichier"))
+	{
+	  fprintf (stderr, "call 2 returned: %s\n", s);
+	  result = 1;
+	}
+    }
+
+  textdomain_cache_stats (&info);
+  if (info.entries != 1 || info.limit != 1)
+    {
+      fprintf (stderr, "cache holds %lu entries, limit %lu\n",
+	       info.entries, info.limit);
+      result = 1;
+    }
+  if (info.evictions == 0)
+    {
+      fprintf (stderr, "no entries were evicted\n");
+      result = 1;
+    }
+
+  /* A repeated lookup of the same message is answered from the cache.  */
+  textdomain_cache_limit (0);
+  s = gettext ("cheese");
+  textdomain_cache_stats (&info);
+  i = info.hits;
+  s = gettext ("cheese");
+  textdomain_cache_stats (&info);
+  if (info.hits != i + 1)
+    {
+      fprintf (stderr, "repeated lookup was not a cache hit\n");
+      result = 1;
+    }
+
+  return result;
+}
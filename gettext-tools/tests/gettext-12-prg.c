@@ -0,0 +1,90 @@
+/* Test program, used by the gettext-12 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+int
+main ()
+{
+  struct textdomain_context *fr;
+  struct textdomain_context *c;
+  char *s;
+  int result = 0;
+
+  bindtextdomain ("context", "gt-12");
+
+  /* The first language of the list has no catalog; the second one has.  */
+  fr = textdomain_context_new ("context", LC_MESSAGES, "xx:fr");
+  c = textdomain_context_new ("context", LC_MESSAGES, "C");
+  if (fr == NULL || c == NULL)
+    {
+      fprintf (stderr, "textdomain_context_new failed\n");
+      return 1;
+    }
+
+  s = textdomain_context_gettext (fr, "cheese");
+  if (strcmp (s, "fromage"))
+    {
+      fprintf (stderr, "call 1 returned: %s\n", s);
+      result = 1;
+    }
+
+  s = textdomain_context_ngettext (fr, "file", "files", 2);
+  if (strcmp (s, "fichiers"))
+    {
+      fprintf (stderr, "call 2 returned: %s\n", s);
+      result = 1;
+    }
+
+  s = textdomain_context_gettext (c, "cheese");
+  if (strcmp (s, "cheese"))
+    {
+      fprintf (stderr, "call 3 returned: %s\n", s);
+      result = 1;
+    }
+
+  s = textdomain_context_ngettext (c, "file", "files", 2);
+  if (strcmp (s, "files"))
+    {
+      fprintf (stderr, "call 4 returned: %s\n", s);
+      result = 1;
+    }
+
+  /* The context follows changes of the binding.  */
+  bindtextdomain ("context", "gt-12/nonexistent");
+  s = textdomain_context_gettext (fr, "cheese");
+  if (strcmp (s, "cheese"))
+    {
+      fprintf (stderr, "call 5 returned: %s\n", s);
+      result = 1;
+    }
+
+  textdomain_context_free (fr);
+  textdomain_context_free (c);
+
+  return result;
+}
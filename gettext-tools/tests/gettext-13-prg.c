@@ -0,0 +1,126 @@
+/* Test program, used by the gettext-13 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* Replace gt-13/catalogs.lst by a list of the catalogs of DOMAINS.  */
+static void
+write_catalog_list (const char *domains[])
+{
+  FILE *fp = fopen ("gt-13/catalogs.lst", "w");
+  int i;
+
+  if (fp == NULL)
+    {
+      perror ("gt-13/catalogs.lst");
+      exit (1);
+    }
+  for (i = 0; domains[i] != NULL; i++)
+    fprintf (fp, "fr/LC_MESSAGES/%s.mo\n", domains[i]);
+  if (fclose (fp) != 0)
+    {
+      perror ("gt-13/catalogs.lst");
+      exit (1);
+    }
+}
+
+static int
+check (const char *domain, const char *expected, int call)
+{
+  struct textdomain_context *context;
+  const char *s;
+  int result = 0;
+
+  context = textdomain_context_new (domain, LC_MESSAGES, "fr");
+  if (context == NULL)
+    {
+      fprintf (stderr, "textdomain_context_new failed\n");
+      return 1;
+    }
+  s = textdomain_context_gettext (context, "cheese");
+  if (strcmp (s, expected))
+    {
+      fprintf (stderr, "call %d returned: %s\n", call, s);
+      result = 1;
+    }
+  textdomain_context_free (context);
+  return result;
+}
+
+int
+main ()
+{
+  static const char *list1[] = { "listed", "reloaded", NULL };
+  static const char *list2[] = { "listed", "reloaded", "rebound", NULL };
+  struct textdomain_context *listed;
+  struct textdomain_context *unlisted;
+  char *s;
+  int result = 0;
+
+  bindtextdomain ("listed", "gt-13");
+  bindtextdomain ("unlisted", "gt-13");
+  bindtextdomain ("reloaded", "gt-13");
+
+  /* The catalog is found through the last variant of the locale name.  */
+  listed = textdomain_context_new ("listed", LC_MESSAGES, "fr_FR.UTF-8@euro");
+  unlisted = textdomain_context_new ("unlisted", LC_MESSAGES, "fr");
+  if (listed == NULL || unlisted == NULL)
+    {
+      fprintf (stderr, "textdomain_context_new failed\n");
+      return 1;
+    }
+
+  s = textdomain_context_gettext (listed, "cheese");
+  if (strcmp (s, "fromage"))
+    {
+      fprintf (stderr, "call 1 returned: %s\n", s);
+      result = 1;
+    }
+
+  /* This catalog exists, but catalogs.lst does not mention it.  */
+  s = textdomain_context_gettext (unlisted, "cheese");
+  if (strcmp (s, "cheese"))
+    {
+      fprintf (stderr, "call 2 returned: %s\n", s);
+      result = 1;
+    }
+
+  textdomain_context_free (listed);
+  textdomain_context_free (unlisted);
+
+  /* The list is read again after textdomain_reload().  */
+  write_catalog_list (list1);
+  textdomain_reload ("listed");
+  result |= check ("reloaded", "fromage", 3);
+
+  /* ... and after bindtextdomain().  */
+  write_catalog_list (list2);
+  bindtextdomain ("rebound", "gt-13");
+  result |= check ("rebound", "fromage", 4);
+
+  return result;
+}
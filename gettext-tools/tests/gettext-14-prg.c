@@ -0,0 +1,75 @@
+/* Test program, used by the gettext-14 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+static int
+check (const char *domain, const char *languages, const char *msgid,
+       const char *expected, int call)
+{
+  struct textdomain_context *context;
+  const char *s;
+  int result = 0;
+
+  context = textdomain_context_new (domain, LC_MESSAGES, languages);
+  if (context == NULL)
+    {
+      fprintf (stderr, "textdomain_context_new failed\n");
+      return 1;
+    }
+  s = textdomain_context_gettext (context, msgid);
+  if (strcmp (s, expected))
+    {
+      fprintf (stderr, "call %d returned: %s\n", call, s);
+      result = 1;
+    }
+  textdomain_context_free (context);
+  return result;
+}
+
+int
+main ()
+{
+  int result = 0;
+
+  bindtextdomain ("cheese", "gt-14.bundle");
+  bindtextdomain ("milk", "gt-14.bundle");
+  /* A regular file that is not a bundle.  */
+  bindtextdomain ("butter", "gt-14/de/milk.po");
+
+  /* The catalogs are found through the last variant of the locale name.  */
+  result |= check ("cheese", "fr_FR.UTF-8@euro", "cheese", "fromage", 1);
+  result |= check ("cheese", "de_DE", "cheese", "Kaese", 2);
+  result |= check ("milk", "de", "milk", "Milch", 3);
+
+  /* The bundle has no such catalogs.  */
+  result |= check ("milk", "fr", "milk", "milk", 4);
+  result |= check ("cheese", "it", "cheese", "cheese", 5);
+  result |= check ("butter", "de", "butter", "butter", 6);
+
+  return result;
+}
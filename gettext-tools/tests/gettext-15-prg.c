@@ -0,0 +1,212 @@
+/* Test program, used by the gettext-15 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if USE_POSIX_THREADS
+
+#include <pthread.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* Number of times the catalog is replaced.  */
+#define REPLACE_COUNT 201
+
+/* Set to 1 if the program is not behaving correctly.  */
+static int result;
+
+/* Set to 1 when the lookup thread shall stop.  */
+static volatile int done;
+
+/* Number of messages in the catalog.  The lookup thread needs more time to
+   look up all of them than a reload takes, so that it is nearly always
+   searching the catalog and entering the results in the cache.  */
+#define MESSAGE_COUNT 1000
+
+/* The translations of "message N" in the two versions of the catalog.  */
+static const char *translation_formats[2] = { "Nachricht %d", "Meldung %d" };
+
+/* The contents of the two versions of the catalog.  */
+static char *contents[2];
+static size_t lengths[2];
+
+static void
+read_file (const char *filename, char **contentsp, size_t *lengthp)
+{
+  FILE *fp = fopen (filename, "rb");
+  long length;
+
+  if (fp == NULL
+      || fseek (fp, 0, SEEK_END) != 0
+      || (length = ftell (fp)) < 0
+      || fseek (fp, 0, SEEK_SET) != 0)
+    {
+      perror (filename);
+      exit (1);
+    }
+  *contentsp = (char *) malloc (length);
+  if (*contentsp == NULL
+      || fread (*contentsp, 1, length, fp) != (size_t) length)
+    {
+      perror (filename);
+      exit (1);
+    }
+  fclose (fp);
+  *lengthp = length;
+}
+
+/* Replace the catalog by version I, atomically, as a hot patch would do.  */
+static void
+install_version (int i)
+{
+  FILE *fp = fopen ("gt-15/tmp.mo", "wb");
+
+  if (fp == NULL
+      || fwrite (contents[i], 1, lengths[i], fp) != lengths[i]
+      || fclose (fp) != 0
+      || rename ("gt-15/tmp.mo", "gt-15/fr/LC_MESSAGES/reload.mo") != 0)
+    {
+      perror ("gt-15/tmp.mo");
+      exit (1);
+    }
+}
+
+/* Check that the lookups of all messages give the translations of
+   version I.  */
+static void
+check_version (int i, const char *when)
+{
+  int m;
+
+  for (m = 0; m < MESSAGE_COUNT; m++)
+    {
+      char msgid[20];
+      char expected[30];
+      const char *s;
+
+      sprintf (msgid, "message %d", m);
+      sprintf (expected, translation_formats[i], m);
+      s = dgettext ("reload", msgid);
+      if (strcmp (s, expected) != 0)
+        {
+          fprintf (stderr, "%s, lookup of %s returned: %s\n",
+                   when, msgid, s);
+          result = 1;
+        }
+    }
+}
+
+static void *
+lookup_thread (void *arg)
+{
+  int m = 0;
+
+  while (!done)
+    {
+      char msgid[20];
+      char expected[2][30];
+      const char *s;
+
+      sprintf (msgid, "message %d", m);
+      sprintf (expected[0], translation_formats[0], m);
+      sprintf (expected[1], translation_formats[1], m);
+      s = dgettext ("reload", msgid);
+      if (strcmp (s, expected[0]) != 0 && strcmp (s, expected[1]) != 0)
+        {
+          fprintf (stderr, "lookup of %s returned: %s\n", msgid, s);
+          result = 1;
+        }
+      m = (m + 1) % MESSAGE_COUNT;
+    }
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  pthread_t thread;
+  int i;
+
+  /* Clean up environment.  */
+  unsetenv ("LANGUAGE");
+  unsetenv ("LC_ALL");
+  unsetenv ("LC_MESSAGES");
+  unsetenv ("LC_CTYPE");
+  unsetenv ("LANG");
+  unsetenv ("OUTPUT_CHARSET");
+
+  xsetenv ("LC_ALL", argv[1], 1);
+  setlocale (LC_ALL, "");
+  bindtextdomain ("reload", "gt-15");
+
+  read_file ("gt-15/reload-1.mo", &contents[0], &lengths[0]);
+  read_file ("gt-15/reload-2.mo", &contents[1], &lengths[1]);
+  install_version (0);
+  check_version (0, "before the reloads");
+
+  if (pthread_create (&thread, NULL, lookup_thread, NULL) != 0)
+    exit (2);
+
+  /* Replace the catalog while the other thread keeps looking up.  The two
+     versions have different sizes, therefore every replacement is seen.  */
+  for (i = 1; i <= REPLACE_COUNT; i++)
+    {
+      int n;
+
+      install_version (i % 2);
+      n = textdomain_reload ("reload");
+      if (n != 1)
+        {
+          fprintf (stderr, "reload %d returned: %d\n", i, n);
+          result = 1;
+        }
+
+      /* No translation from the previous version may have been entered in
+         the cache as current.  */
+      check_version (i % 2, "after a reload");
+    }
+
+  done = 1;
+  if (pthread_join (thread, NULL) != 0)
+    exit (3);
+
+  check_version (REPLACE_COUNT % 2, "at the end");
+
+  return result;
+}
+
+#else
+
+/* This test is not executed.  */
+
+int
+main (void)
+{
+  fputs ("Skipping test: multithreading not enabled\n", stderr);
+  return 77;
+}
+
+#endif
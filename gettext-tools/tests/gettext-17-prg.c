@@ -0,0 +1,112 @@
+/* Test program, used by the gettext-17 test.
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* Copy the file FROM to gt-17.bundle, atomically, as an update of the
+   installed bundle would do.  */
+static void
+install (const char *from)
+{
+  FILE *in = fopen (from, "rb");
+  FILE *out = fopen ("gt-17.tmp", "wb");
+  char buf[4096];
+  size_t n;
+
+  if (in == NULL || out == NULL)
+    {
+      perror (from);
+      exit (1);
+    }
+  while ((n = fread (buf, 1, sizeof buf, in)) > 0)
+    if (fwrite (buf, 1, n, out) != n)
+      {
+        perror ("gt-17.tmp");
+        exit (1);
+      }
+  fclose (in);
+  if (fclose (out) != 0 || rename ("gt-17.tmp", "gt-17.bundle") != 0)
+    {
+      perror ("gt-17.tmp");
+      exit (1);
+    }
+}
+
+static int
+check (int expected_count, const char *expected, int call)
+{
+  int count = textdomain_reload ("milk");
+  const char *s = dgettext ("milk", "milk");
+  int result = 0;
+
+  if (count != expected_count)
+    {
+      fprintf (stderr, "reload %d returned: %d\n", call, count);
+      result = 1;
+    }
+  if (strcmp (s, expected) != 0)
+    {
+      fprintf (stderr, "lookup %d returned: %s\n", call, s);
+      result = 1;
+    }
+  return result;
+}
+
+int
+main (int argc, char *argv[])
+{
+  int result = 0;
+
+  /* Clean up environment.  */
+  unsetenv ("LANGUAGE");
+  unsetenv ("LC_ALL");
+  unsetenv ("LC_MESSAGES");
+  unsetenv ("LC_CTYPE");
+  unsetenv ("LANG");
+  unsetenv ("OUTPUT_CHARSET");
+
+  xsetenv ("LC_ALL", argv[1], 1);
+  setlocale (LC_ALL, "");
+  bindtextdomain ("milk", "gt-17.bundle");
+
+  /* At first the file is no bundle.  */
+  install ("gt-17/fr/milk.po");
+  result |= check (0, "milk", 1);
+
+  install ("gt-17-1.bundle");
+  result |= check (1, "lait", 2);
+
+  /* Nothing has changed.  */
+  result |= check (0, "lait", 3);
+
+  install ("gt-17-2.bundle");
+  result |= check (1, "babeurre", 4);
+
+  return result;
+}
@@ -25,8 +25,10 @@
 VARIABLE(allow_duplicates)
 VARIABLE(color_mode)
 VARIABLE(color_test_mode)
+VARIABLE(discard_comments)
 VARIABLE(format_language)
 VARIABLE(format_language_pretty)
+VARIABLE(format_reuse_msgid_descriptors)
 VARIABLE(formatstring_arma)
 VARIABLE(formatstring_awk)
 VARIABLE(formatstring_boost)